@@ -0,0 +1,418 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_ALIGNED_VECTOR_H
+#define CORSAC_ECS_ALIGNED_VECTOR_H
+
+#include "Corsac/type_traits.h"
+#include "Corsac/algorithm.h"
+#include "Corsac/tuple.h"
+
+#include <new>
+
+#ifndef CORSAC_ECS_COLUMN_ALIGNMENT
+    #define CORSAC_ECS_COLUMN_ALIGNMENT 64
+#endif
+
+#ifndef CORSAC_ECS_SIMD_WIDTH
+    #define CORSAC_ECS_SIMD_WIDTH 16
+#endif
+
+namespace corsac
+{
+    namespace internal
+    {
+        /**
+         * aligned_vector
+         *
+         * Колонка хранилища ALIGNED: начало выровнено по alignment байт, емкость кратна
+         * width элементам. Все элементы до емкости сконструированы, элементы за size()
+         * всегда равны T(), поэтому ядра могут обходить [0, padded_size()) целыми регистрами.
+         */
+        template<typename T, size_t alignment, size_t width>
+        class aligned_vector
+        {
+            static_assert(alignment >= alignof(T) && (alignment & (alignment - 1)) == 0,
+                          "aligned_vector<alignment> - alignment must be a power of two not less than alignof(T)");
+            static_assert(width != 0, "aligned_vector<width> - width must not be zero");
+
+        public:
+            using value_type                = T;
+            using size_type                 = size_t;
+            using pointer                   = T*;
+            using const_pointer             = const T*;
+            using reference                 = T&;
+            using const_reference           = const T&;
+            using iterator                  = T*;
+            using const_iterator            = const T*;
+            using reverse_iterator          = corsac::reverse_iterator<iterator>;
+            using const_reverse_iterator    = corsac::reverse_iterator<const_iterator>;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+            T* mpBegin      = nullptr;
+            T* mpEnd        = nullptr;
+            T* mpCapacity   = nullptr;
+
+        public:
+            aligned_vector() noexcept = default;
+            aligned_vector(const aligned_vector& x);
+            aligned_vector(aligned_vector&& x) noexcept;
+            ~aligned_vector();
+
+            aligned_vector& operator=(const aligned_vector& x);
+            aligned_vector& operator=(aligned_vector&& x) noexcept;
+
+            iterator       begin() noexcept { return mpBegin; }
+            const_iterator begin() const noexcept { return mpBegin; }
+            iterator       end() noexcept { return mpEnd; }
+            const_iterator end() const noexcept { return mpEnd; }
+
+            reverse_iterator       rbegin() noexcept { return reverse_iterator(mpEnd); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(mpEnd); }
+            reverse_iterator       rend() noexcept { return reverse_iterator(mpBegin); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(mpBegin); }
+
+            reference       front() { return *mpBegin; }
+            const_reference front() const { return *mpBegin; }
+            reference       back() { return *(mpEnd - 1); }
+            const_reference back() const { return *(mpEnd - 1); }
+
+            reference       operator[](size_type n) { return mpBegin[n]; }
+            const_reference operator[](size_type n) const { return mpBegin[n]; }
+
+            pointer       data() noexcept { return mpBegin; }
+            const_pointer data() const noexcept { return mpBegin; }
+
+            [[nodiscard]] bool      empty() const noexcept { return mpBegin == mpEnd; }
+            [[nodiscard]] size_type size() const noexcept { return static_cast<size_type>(mpEnd - mpBegin); }
+            [[nodiscard]] size_type capacity() const noexcept { return static_cast<size_type>(mpCapacity - mpBegin); }
+
+            // size(), округленный вверх до width.
+            [[nodiscard]] size_type padded_size() const noexcept { return round_up(size()); }
+
+            reference push_back();
+            void      push_back(const value_type& value);
+            void      push_back(value_type&& value);
+            void      pop_back() noexcept;
+
+            void resize(size_type n);
+            void resize(size_type n, const value_type& value);
+            void reserve(size_type n);
+            void set_capacity(size_type n = npos);
+            void shrink_to_fit();
+
+            void clear() noexcept;
+            void reset_lose_memory() noexcept;
+
+        private:
+            static constexpr size_type round_up(size_type n) noexcept
+            {
+                return (n + width - 1) / width * width;
+            }
+
+            void grow(size_type n);
+            void reallocate(size_type n);
+            void release() noexcept;
+        };
+
+        template<typename T, size_t alignment, size_t width>
+        inline aligned_vector<T, alignment, width>::aligned_vector(const aligned_vector& x)
+        {
+            reallocate(x.capacity());
+            corsac::copy(x.mpBegin, x.mpEnd, mpBegin);
+            mpEnd = mpBegin + x.size();
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline aligned_vector<T, alignment, width>::aligned_vector(aligned_vector&& x) noexcept
+            : mpBegin(x.mpBegin), mpEnd(x.mpEnd), mpCapacity(x.mpCapacity)
+        {
+            x.reset_lose_memory();
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline aligned_vector<T, alignment, width>::~aligned_vector()
+        {
+            release();
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline aligned_vector<T, alignment, width>&
+        aligned_vector<T, alignment, width>::operator=(const aligned_vector& x)
+        {
+            if (this != &x)
+            {
+                aligned_vector tmp(x);
+                *this = corsac::move(tmp);
+            }
+            return *this;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline aligned_vector<T, alignment, width>&
+        aligned_vector<T, alignment, width>::operator=(aligned_vector&& x) noexcept
+        {
+            if (this != &x)
+            {
+                release();
+                mpBegin = x.mpBegin;
+                mpEnd = x.mpEnd;
+                mpCapacity = x.mpCapacity;
+                x.reset_lose_memory();
+            }
+            return *this;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline typename aligned_vector<T, alignment, width>::reference
+        aligned_vector<T, alignment, width>::push_back()
+        {
+            if (mpEnd == mpCapacity)
+                grow(size() + 1);
+            return *mpEnd++;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::push_back(const value_type& value)
+        {
+            if (mpEnd == mpCapacity)
+            {
+                // value может лежать в этой же колонке.
+                const value_type copy(value);
+                grow(size() + 1);
+                *mpEnd++ = copy;
+                return;
+            }
+            *mpEnd++ = value;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::push_back(value_type&& value)
+        {
+            if (mpEnd == mpCapacity)
+                grow(size() + 1);
+            *mpEnd++ = corsac::move(value);
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::pop_back() noexcept
+        {
+            *--mpEnd = T();
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::resize(size_type n)
+        {
+            resize(n, T());
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::resize(size_type n, const value_type& value)
+        {
+            const size_type count = size();
+            if (n > capacity())
+                reallocate(round_up(n));
+            if (n > count)
+                corsac::fill(mpBegin + count, mpBegin + n, value);
+            else
+                corsac::fill(mpBegin + n, mpEnd, T());
+            mpEnd = mpBegin + n;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::reserve(size_type n)
+        {
+            if (n > capacity())
+                reallocate(round_up(n));
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::set_capacity(size_type n)
+        {
+            if (n == npos)
+                n = size();
+            if (n < size())
+                resize(n);
+            reallocate(round_up(n));
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::shrink_to_fit()
+        {
+            if (round_up(size()) != capacity())
+                reallocate(round_up(size()));
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::clear() noexcept
+        {
+            corsac::fill(mpBegin, mpEnd, T());
+            mpEnd = mpBegin;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::reset_lose_memory() noexcept
+        {
+            mpBegin = mpEnd = mpCapacity = nullptr;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::grow(size_type n)
+        {
+            reallocate(round_up(corsac::max(n, capacity() * 2)));
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::reallocate(size_type n)
+        {
+            const size_type count = corsac::min(size(), n);
+            T* data = nullptr;
+            if (n != 0)
+            {
+                data = static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+                for (size_type i = 0; i < n; ++i)
+                    ::new(static_cast<void*>(data + i)) T(i < count ? corsac::move(mpBegin[i]) : T());
+            }
+            release();
+            mpBegin = data;
+            mpEnd = data + count;
+            mpCapacity = data + n;
+        }
+
+        template<typename T, size_t alignment, size_t width>
+        inline void aligned_vector<T, alignment, width>::release() noexcept
+        {
+            if (!mpBegin)
+                return;
+            for (T* p = mpBegin; p != mpCapacity; ++p)
+                p->~T();
+            ::operator delete(mpBegin, std::align_val_t(alignment));
+            reset_lose_memory();
+        }
+
+        // Результат column_tuple_vector::at(), присваивается целой строкой: at(n) = {x, y}.
+        template<typename... Ts>
+        struct aligned_tuple_ref
+        {
+            corsac::tuple<Ts&...> refs;
+
+            explicit aligned_tuple_ref(const corsac::tuple<Ts&...>& r) noexcept : refs(r) {}
+
+            aligned_tuple_ref& operator=(const corsac::tuple<Ts...>& value)
+            {
+                refs = value;
+                return *this;
+            }
+        };
+
+        /**
+         * column_tuple_vector
+         *
+         * Колонки одинаковой длины и емкости, интерфейс как у tuple_vector.
+         * mpBegin указывает на начало первой колонки.
+         */
+        template<typename... Columns>
+        class column_tuple_vector
+        {
+            using columns_type = corsac::tuple<Columns...>;
+            using index_sequence = corsac::index_sequence_for<Columns...>;
+
+        public:
+            using size_type = size_t;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+            void* mpBegin = nullptr;
+
+        protected:
+            columns_type columns;
+
+        public:
+            template<size_t I>
+            auto get() noexcept { return corsac::get<I>(columns).data(); }
+
+            template<size_t I>
+            auto get() const noexcept { return corsac::get<I>(columns).data(); }
+
+            corsac::tuple<typename Columns::value_type&...>       operator[](size_type n) { return refs(n, index_sequence()); }
+            corsac::tuple<const typename Columns::value_type&...> operator[](size_type n) const { return refs(n, index_sequence()); }
+
+            aligned_tuple_ref<typename Columns::value_type...> at(size_type n)
+            {
+                return aligned_tuple_ref<typename Columns::value_type...>(refs(n, index_sequence()));
+            }
+
+            corsac::tuple<typename Columns::value_type&...>       front() { return (*this)[0]; }
+            corsac::tuple<const typename Columns::value_type&...> front() const { return (*this)[0]; }
+            corsac::tuple<typename Columns::value_type&...>       back() { return (*this)[size() - 1]; }
+            corsac::tuple<const typename Columns::value_type&...> back() const { return (*this)[size() - 1]; }
+
+            [[nodiscard]] bool      empty() const noexcept { return size() == 0; }
+            [[nodiscard]] size_type size() const noexcept { return corsac::get<0>(columns).size(); }
+            [[nodiscard]] size_type capacity() const noexcept { return corsac::get<0>(columns).capacity(); }
+            [[nodiscard]] size_type padded_size() const noexcept { return corsac::get<0>(columns).padded_size(); }
+
+            void push_back()
+            {
+                each([](auto& column) { column.push_back(); });
+            }
+
+            template<typename... Args>
+            void push_back(Args&&... data)
+            {
+                static_assert(sizeof...(Args) == sizeof...(Columns), "column_tuple_vector::push_back - one value per column");
+                push_back(index_sequence(), corsac::forward<Args>(data)...);
+            }
+
+            void pop_back() noexcept
+            {
+                each([](auto& column) { column.pop_back(); });
+            }
+
+            void resize(size_type n) { each([n](auto& column) { column.resize(n); }); }
+            void reserve(size_type n) { each([n](auto& column) { column.reserve(n); }); }
+            void set_capacity(size_type n = npos) { each([n](auto& column) { column.set_capacity(n); }); }
+            void shrink_to_fit() { each([](auto& column) { column.shrink_to_fit(); }); }
+
+            void clear() noexcept { each([](auto& column) { column.clear(); }); }
+            void reset_lose_memory() noexcept { each([](auto& column) { column.reset_lose_memory(); }); }
+
+        protected:
+            // Применяет f к каждой колонке и обновляет mpBegin после возможного перевыделения.
+            template<typename F>
+            void each(F&& f)
+            {
+                corsac::apply([&f](auto&... column) { (f(column), ...); }, columns);
+                mpBegin = corsac::get<0>(columns).data();
+            }
+
+        private:
+            template<size_t... I>
+            corsac::tuple<typename Columns::value_type&...> refs(size_type n, corsac::index_sequence<I...>)
+            {
+                return corsac::tuple<typename Columns::value_type&...>(corsac::get<I>(columns)[n]...);
+            }
+
+            template<size_t... I>
+            corsac::tuple<const typename Columns::value_type&...> refs(size_type n, corsac::index_sequence<I...>) const
+            {
+                return corsac::tuple<const typename Columns::value_type&...>(corsac::get<I>(columns)[n]...);
+            }
+
+            template<size_t... I, typename... Args>
+            void push_back(corsac::index_sequence<I...>, Args&&... data)
+            {
+                (corsac::get<I>(columns).push_back(corsac::forward<Args>(data)), ...);
+                mpBegin = corsac::get<0>(columns).data();
+            }
+        };
+
+        // Колонки aligned_vector, выровненные по alignment байт с емкостью кратной width.
+        template<size_t alignment, size_t width, typename... Ts>
+        using aligned_tuple_vector = column_tuple_vector<aligned_vector<Ts, alignment, width>...>;
+    }
+}
+
+#endif //CORSAC_ECS_ALIGNED_VECTOR_H
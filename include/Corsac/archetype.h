@@ -0,0 +1,710 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_ARCHETYPE_H
+#define CORSAC_ECS_ARCHETYPE_H
+
+#include "Corsac/component.h"
+#include "Corsac/tuple.h"
+#include "Corsac/vector.h"
+
+#include <cstring>
+#include <memory>
+#include <new>
+
+#ifndef CORSAC_ECS_CHUNK_SIZE
+    #define CORSAC_ECS_CHUNK_SIZE 16384
+#endif
+
+#ifndef CORSAC_ECS_CHUNK_ALIGNMENT
+    #define CORSAC_ECS_CHUNK_ALIGNMENT 64
+#endif
+
+namespace corsac
+{
+    namespace internal
+    {
+        using archetype_signature = uint64_t;
+
+        // Максимум компонентов ARCHETYPE: по биту сигнатуры на компонент.
+        static constexpr size_t archetype_max_components = sizeof(archetype_signature) * 8;
+        static constexpr size_t archetype_npos = static_cast<size_t>(-1);
+
+        struct archetype_field
+        {
+            size_t size;
+            size_t align;
+        };
+
+        struct archetype_column
+        {
+            size_t component;
+            size_t size;
+            size_t offset;
+        };
+
+        /**
+         * archetype
+         *
+         * Сущности с одинаковым набором компонентов ARCHETYPE. Строки лежат плотно в чанках
+         * по CORSAC_ECS_CHUNK_SIZE байт: строка row - позиция row % capacity чанка row / capacity.
+         * Внутри чанка у каждого поля каждого компонента своя колонка, колонка 0 - ID сущностей.
+         */
+        class archetype
+        {
+        public:
+            archetype_signature         signature;
+            corsac::vector<archetype_column> columns;
+            size_t                      capacity = 0;
+            size_t                      count    = 0;
+            corsac::vector<uint8_t*>    chunks;
+
+            // Первая колонка компонента или archetype_npos.
+            size_t                      first[archetype_max_components];
+            // Переходы при добавлении и удалении компонента, вычисляются по требованию.
+            size_t                      addEdge[archetype_max_components];
+            size_t                      removeEdge[archetype_max_components];
+
+        public:
+            archetype(archetype_signature s, const corsac::vector<corsac::vector<archetype_field>>& components);
+            ~archetype();
+
+            archetype(const archetype&) = delete;
+            archetype& operator=(const archetype&) = delete;
+
+            [[nodiscard]] bool contains(size_t component) const noexcept
+            {
+                return (signature >> component) & 1u;
+            }
+
+            uint8_t* column(size_t c, size_t row) const noexcept
+            {
+                return chunks[row / capacity] + columns[c].offset + (row % capacity) * columns[c].size;
+            }
+
+            // Начало колонки c в чанке chunk.
+            uint8_t* chunk_column(size_t c, size_t chunk) const noexcept
+            {
+                return chunks[chunk] + columns[c].offset;
+            }
+
+            EntityType& entity(size_t row) const noexcept
+            {
+                return *reinterpret_cast<EntityType*>(column(0, row));
+            }
+
+            [[nodiscard]] size_t chunk_count() const noexcept
+            {
+                return (count + capacity - 1) / capacity;
+            }
+
+            [[nodiscard]] size_t chunk_size(size_t chunk) const noexcept
+            {
+                return corsac::min(capacity, count - chunk * capacity);
+            }
+
+            size_t push(const EntityType& value);
+
+            // Удаляет строку row, на ее место переносится последняя. Возвращает перенесенный ID
+            // или entity_traits::null, если строка была последней.
+            EntityType erase(size_t row) noexcept;
+
+        private:
+            static uint8_t* allocate_chunk();
+            static void     free_chunk(uint8_t* chunk) noexcept;
+        };
+
+        inline archetype::archetype(archetype_signature s, const corsac::vector<corsac::vector<archetype_field>>& components)
+            : signature(s)
+        {
+            for (size_t i = 0; i < archetype_max_components; ++i)
+            {
+                first[i] = archetype_npos;
+                addEdge[i] = archetype_npos;
+                removeEdge[i] = archetype_npos;
+            }
+
+            corsac::vector<size_t> aligns;
+            columns.push_back(archetype_column{archetype_npos, sizeof(EntityType), 0});
+            aligns.push_back(alignof(EntityType));
+            size_t row = sizeof(EntityType);
+            for (size_t c = 0; c < components.size(); ++c)
+            {
+                if (!contains(c))
+                    continue;
+                first[c] = columns.size();
+                for (const archetype_field& field : components[c])
+                {
+                    columns.push_back(archetype_column{c, field.size, 0});
+                    aligns.push_back(field.align);
+                    row += field.size;
+                }
+            }
+
+            // Наибольшее кол-во строк, при котором колонки с выравниванием помещаются в чанк.
+            for (capacity = CORSAC_ECS_CHUNK_SIZE / row; capacity > 0; --capacity)
+            {
+                size_t offset = 0;
+                for (size_t c = 0; c < columns.size(); ++c)
+                {
+                    offset = (offset + aligns[c] - 1) / aligns[c] * aligns[c];
+                    columns[c].offset = offset;
+                    offset += capacity * columns[c].size;
+                }
+                if (offset <= CORSAC_ECS_CHUNK_SIZE)
+                    break;
+            }
+        #if CORSAC_EXCEPTIONS_ENABLED
+            if(CORSAC_UNLIKELY(capacity == 0))
+                throw std::length_error("archetype -- row does not fit into CORSAC_ECS_CHUNK_SIZE");
+        #elif CORSAC_ASSERT_ENABLED
+            if(CORSAC_UNLIKELY(capacity == 0))
+                CORSAC_FAIL_MSG("archetype -- row does not fit into CORSAC_ECS_CHUNK_SIZE");
+        #endif
+        }
+
+        inline archetype::~archetype()
+        {
+            for (uint8_t* chunk : chunks)
+                free_chunk(chunk);
+        }
+
+        inline size_t archetype::push(const EntityType& value)
+        {
+            if (count == chunks.size() * capacity)
+                chunks.push_back(allocate_chunk());
+            const size_t row = count++;
+            entity(row) = value;
+            return row;
+        }
+
+        inline EntityType archetype::erase(size_t row) noexcept
+        {
+            const size_t last = --count;
+            EntityType moved = entity_traits<EntityType>::null;
+            if (row != last)
+            {
+                for (size_t c = 0; c < columns.size(); ++c)
+                    std::memcpy(column(c, row), column(c, last), columns[c].size);
+                moved = entity(row);
+            }
+            // Один пустой чанк остается в запасе, чтобы add/remove на границе не перевыделяли память.
+            while (chunks.size() > 1 && count + capacity <= (chunks.size() - 1) * capacity)
+            {
+                free_chunk(chunks.back());
+                chunks.pop_back();
+            }
+            return moved;
+        }
+
+        inline uint8_t* archetype::allocate_chunk()
+        {
+            return static_cast<uint8_t*>(::operator new(CORSAC_ECS_CHUNK_SIZE, std::align_val_t(CORSAC_ECS_CHUNK_ALIGNMENT)));
+        }
+
+        inline void archetype::free_chunk(uint8_t* chunk) noexcept
+        {
+            ::operator delete(chunk, std::align_val_t(CORSAC_ECS_CHUNK_ALIGNMENT));
+        }
+
+        /**
+         * archetype_world
+         *
+         * Все архетипы процесса и положение каждой сущности: архетип и строка.
+         * Добавление или удаление компонента переносит строку сущности в соседний архетип.
+         */
+        class archetype_world
+        {
+            struct location
+            {
+                size_t archetype = archetype_npos;
+                size_t row       = 0;
+            };
+
+            using archetype_pointer = std::unique_ptr<archetype>;
+
+        protected:
+            corsac::vector<corsac::vector<archetype_field>> components;
+            corsac::vector<archetype_pointer>               archetypes;
+            corsac::vector<location>                        locations;
+
+        public:
+            archetype_world() noexcept = default;
+
+            size_t register_component(const archetype_field* fields, size_t n);
+
+            [[nodiscard]] bool has(const EntityType& value, size_t component) const noexcept;
+
+            // Адрес поля field компонента component у сущности value, компонент должен быть.
+            uint8_t* field(const EntityType& value, size_t component, size_t field) const noexcept;
+
+            // false, если компонент уже был или его не было.
+            bool add(const EntityType& value, size_t component);
+            bool remove(const EntityType& value, size_t component);
+
+            [[nodiscard]] size_t size() const noexcept;
+            archetype& operator[](size_t n) const noexcept;
+
+        private:
+            const location* find(const EntityType& value) const noexcept;
+            size_t target(size_t from, size_t component, bool adding);
+            void   move(const EntityType& value, size_t to);
+        };
+
+        inline size_t archetype_world::register_component(const archetype_field* fields, size_t n)
+        {
+        #if CORSAC_EXCEPTIONS_ENABLED
+            if(CORSAC_UNLIKELY(components.size() >= archetype_max_components))
+                throw std::out_of_range("archetype_world::register_component -- too many ARCHETYPE components");
+        #elif CORSAC_ASSERT_ENABLED
+            if(CORSAC_UNLIKELY(components.size() >= archetype_max_components))
+                CORSAC_FAIL_MSG("archetype_world::register_component -- too many ARCHETYPE components");
+        #endif
+            components.push_back(corsac::vector<archetype_field>());
+            for (size_t i = 0; i < n; ++i)
+                components.back().push_back(fields[i]);
+            return components.size() - 1;
+        }
+
+        inline bool archetype_world::has(const EntityType& value, size_t component) const noexcept
+        {
+            const location* l = find(value);
+            return l && archetypes[l->archetype]->contains(component);
+        }
+
+        inline uint8_t* archetype_world::field(const EntityType& value, size_t component, size_t field) const noexcept
+        {
+            const location& l = locations[entity_traits<EntityType>::index(value)];
+            const archetype& a = *archetypes[l.archetype];
+            return a.column(a.first[component] + field, l.row);
+        }
+
+        inline bool archetype_world::add(const EntityType& value, size_t component)
+        {
+            const location* l = find(value);
+            const size_t from = l ? l->archetype : archetype_npos;
+            if (from != archetype_npos && archetypes[from]->contains(component))
+                return false;
+            move(value, target(from, component, true));
+            return true;
+        }
+
+        inline bool archetype_world::remove(const EntityType& value, size_t component)
+        {
+            const location* l = find(value);
+            if (!l || !archetypes[l->archetype]->contains(component))
+                return false;
+            move(value, target(l->archetype, component, false));
+            return true;
+        }
+
+        inline size_t archetype_world::size() const noexcept
+        {
+            return archetypes.size();
+        }
+
+        inline archetype& archetype_world::operator[](size_t n) const noexcept
+        {
+            return *archetypes[n];
+        }
+
+        inline const archetype_world::location* archetype_world::find(const EntityType& value) const noexcept
+        {
+            const size_t index = entity_traits<EntityType>::index(value);
+            if (index >= locations.size() || locations[index].archetype == archetype_npos)
+                return nullptr;
+            const location& l = locations[index];
+            return archetypes[l.archetype]->entity(l.row) == value ? &l : nullptr;
+        }
+
+        inline size_t archetype_world::target(size_t from, size_t component, bool adding)
+        {
+            size_t* edge = nullptr;
+            archetype_signature signature = archetype_signature(1) << component;
+            if (from != archetype_npos)
+            {
+                archetype& a = *archetypes[from];
+                edge = adding ? &a.addEdge[component] : &a.removeEdge[component];
+                if (*edge != archetype_npos)
+                    return *edge;
+                signature = adding ? (a.signature | signature) : (a.signature & ~signature);
+            }
+
+            size_t result = archetype_npos;
+            if (signature != 0)
+            {
+                for (size_t i = 0; i < archetypes.size() && result == archetype_npos; ++i)
+                {
+                    if (archetypes[i]->signature == signature)
+                        result = i;
+                }
+                if (result == archetype_npos)
+                {
+                    archetypes.push_back(archetype_pointer(new archetype(signature, components)));
+                    result = archetypes.size() - 1;
+                }
+            }
+            if (edge)
+                *edge = result;
+            return result;
+        }
+
+        inline void archetype_world::move(const EntityType& value, size_t to)
+        {
+            const size_t index = entity_traits<EntityType>::index(value);
+            if (index >= locations.size())
+                locations.resize(index + 1);
+            location& l = locations[index];
+
+            size_t row = 0;
+            if (to != archetype_npos)
+            {
+                archetype& dst = *archetypes[to];
+                row = dst.push(value);
+                for (size_t c = 1; c < dst.columns.size(); ++c)
+                    std::memset(dst.column(c, row), 0, dst.columns[c].size);
+
+                // Общие компоненты копируются колонка в колонку.
+                if (l.archetype != archetype_npos)
+                {
+                    const archetype& src = *archetypes[l.archetype];
+                    for (size_t c = 1; c < dst.columns.size(); ++c)
+                    {
+                        const size_t component = dst.columns[c].component;
+                        if (src.contains(component))
+                            std::memcpy(dst.column(c, row), src.column(src.first[component] + c - dst.first[component], l.row),
+                                        dst.columns[c].size);
+                    }
+                }
+            }
+
+            if (l.archetype != archetype_npos)
+            {
+                const EntityType moved = archetypes[l.archetype]->erase(l.row);
+                if (moved != entity_traits<EntityType>::null)
+                    locations[entity_traits<EntityType>::index(moved)].row = l.row;
+            }
+            l.archetype = to;
+            l.row = row;
+        }
+
+        inline archetype_world& getArchetypeWorld() noexcept
+        {
+            static archetype_world world;
+            return world;
+        }
+    }
+
+    /**
+     * ComponentArchetype
+     *
+     * Компонент хранилища ARCHETYPE: данные лежат в чанках архетипов общего мира,
+     * вместе с остальными ARCHETYPE компонентами сущности. Поля должны быть тривиально копируемыми,
+     * строки переносятся между архетипами через memcpy. Ссылки из get() действительны
+     * до следующего add/remove любого ARCHETYPE компонента.
+     * Бита в реестре сигнатур нет, destroy() снимает сущность через список overflow.
+     */
+    template<typename... Ts>
+    class ComponentArchetype
+    {
+        static_assert((corsac::is_trivially_copyable<Ts>::value && ...),
+                      "ComponentArchetype - values must be trivially copyable");
+
+        using index_sequence = corsac::index_sequence_for<Ts...>;
+
+    public:
+        using size_type   = size_t;
+        using value_tuple = corsac::tuple<Ts...>;
+
+        static constexpr internal::ComponentType component_type = internal::CHUNK;
+
+    protected:
+        size_type                id;
+        size_type                count = 0;
+        internal::registry_entry entry;
+
+    public:
+        ComponentArchetype();
+
+        ComponentArchetype(const ComponentArchetype&) = delete;
+        ComponentArchetype& operator=(const ComponentArchetype&) = delete;
+
+        // Бит компонента в сигнатуре архетипа.
+        [[nodiscard]] size_type component_id() const noexcept;
+
+        [[nodiscard]] bool      has(const EntityType& value) const noexcept;
+        [[nodiscard]] bool      empty() const noexcept;
+        [[nodiscard]] size_type size() const noexcept;
+
+        template<size_t I = 0>
+        auto& get(const EntityType& value);
+
+        template<size_t I = 0>
+        const auto& get(const EntityType& value) const;
+
+        void add(const EntityType& value);
+
+        template<typename ...Args>
+        void add(const EntityType& value, Args&&... data);
+
+        void set(const EntityType& value);
+
+        template<typename ...Args>
+        void set(const EntityType& value, Args&&... data);
+
+        void fit(const EntityType& value);
+
+        template<typename ...Args>
+        void fit(const EntityType& value, Args&&... data);
+
+        void remove(const EntityType& value);
+
+        // Указатели на колонки компонента в чанке chunk архетипа a.
+        auto columns(const internal::archetype& a, size_type chunk) const noexcept;
+
+    private:
+        template<size_t... I, typename ...Args>
+        void write(const EntityType& value, corsac::index_sequence<I...>, Args&&... data);
+
+        template<size_t... I>
+        auto columns(const internal::archetype& a, size_type chunk, corsac::index_sequence<I...>) const noexcept;
+    };
+
+    template<typename... Ts>
+    inline ComponentArchetype<Ts...>::ComponentArchetype()
+    {
+        const internal::archetype_field fields[sizeof...(Ts) + 1] = {{sizeof(Ts), alignof(Ts)}..., {0, 1}};
+        id = internal::getArchetypeWorld().register_component(fields, sizeof...(Ts));
+        entry.enroll_overflow(this);
+    }
+
+    template<typename... Ts>
+    inline typename ComponentArchetype<Ts...>::size_type ComponentArchetype<Ts...>::component_id() const noexcept
+    {
+        return id;
+    }
+
+    template<typename... Ts>
+    inline bool ComponentArchetype<Ts...>::has(const EntityType& value) const noexcept
+    {
+        return internal::getArchetypeWorld().has(value, id);
+    }
+
+    template<typename... Ts>
+    inline bool ComponentArchetype<Ts...>::empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    template<typename... Ts>
+    inline typename ComponentArchetype<Ts...>::size_type ComponentArchetype<Ts...>::size() const noexcept
+    {
+        return count;
+    }
+
+    template<typename... Ts>
+    template<size_t I>
+    inline auto& ComponentArchetype<Ts...>::get(const EntityType& value)
+    {
+        using T = corsac::tuple_element_t<I, value_tuple>;
+    #if CORSAC_EXCEPTIONS_ENABLED
+        if(CORSAC_UNLIKELY(!has(value)))
+            throw std::out_of_range("ComponentArchetype::get -- out of range");
+    #elif CORSAC_ASSERT_ENABLED
+        if(CORSAC_UNLIKELY(!has(value)))
+            CORSAC_FAIL_MSG("ComponentArchetype::get -- out of range");
+    #endif
+        return *reinterpret_cast<T*>(internal::getArchetypeWorld().field(value, id, I));
+    }
+
+    template<typename... Ts>
+    template<size_t I>
+    inline const auto& ComponentArchetype<Ts...>::get(const EntityType& value) const
+    {
+        using T = corsac::tuple_element_t<I, value_tuple>;
+    #if CORSAC_EXCEPTIONS_ENABLED
+        if(CORSAC_UNLIKELY(!has(value)))
+            throw std::out_of_range("ComponentArchetype::get -- out of range");
+    #elif CORSAC_ASSERT_ENABLED
+        if(CORSAC_UNLIKELY(!has(value)))
+            CORSAC_FAIL_MSG("ComponentArchetype::get -- out of range");
+    #endif
+        return *reinterpret_cast<const T*>(internal::getArchetypeWorld().field(value, id, I));
+    }
+
+    template<typename... Ts>
+    inline void ComponentArchetype<Ts...>::add(const EntityType& value)
+    {
+        if (!internal::getArchetypeWorld().add(value, id))
+            return;
+        ++count;
+        write(value, index_sequence(), Ts()...);
+    }
+
+    template<typename... Ts>
+    template<typename ...Args>
+    inline void ComponentArchetype<Ts...>::add(const EntityType& value, Args&&... data)
+    {
+        if (!internal::getArchetypeWorld().add(value, id))
+            return;
+        ++count;
+        write(value, index_sequence(), corsac::forward<Args>(data)...);
+    }
+
+    template<typename... Ts>
+    inline void ComponentArchetype<Ts...>::set(const EntityType& value)
+    {
+        if (internal::getArchetypeWorld().add(value, id))
+            ++count;
+        write(value, index_sequence(), Ts()...);
+    }
+
+    template<typename... Ts>
+    template<typename ...Args>
+    inline void ComponentArchetype<Ts...>::set(const EntityType& value, Args&&... data)
+    {
+        if (internal::getArchetypeWorld().add(value, id))
+            ++count;
+        write(value, index_sequence(), corsac::forward<Args>(data)...);
+    }
+
+    template<typename... Ts>
+    inline void ComponentArchetype<Ts...>::fit(const EntityType& value)
+    {
+        write(value, index_sequence(), Ts()...);
+    }
+
+    template<typename... Ts>
+    template<typename ...Args>
+    inline void ComponentArchetype<Ts...>::fit(const EntityType& value, Args&&... data)
+    {
+        write(value, index_sequence(), corsac::forward<Args>(data)...);
+    }
+
+    template<typename... Ts>
+    inline void ComponentArchetype<Ts...>::remove(const EntityType& value)
+    {
+        if (internal::getArchetypeWorld().remove(value, id))
+            --count;
+    }
+
+    template<typename... Ts>
+    inline auto ComponentArchetype<Ts...>::columns(const internal::archetype& a, size_type chunk) const noexcept
+    {
+        return columns(a, chunk, index_sequence());
+    }
+
+    template<typename... Ts>
+    template<size_t... I, typename ...Args>
+    inline void ComponentArchetype<Ts...>::write(const EntityType& value, corsac::index_sequence<I...>, Args&&... data)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "ComponentArchetype - one value per field");
+        auto& world = internal::getArchetypeWorld();
+        (::new(static_cast<void*>(world.field(value, id, I))) Ts(corsac::forward<Args>(data)), ...);
+    }
+
+    template<typename... Ts>
+    template<size_t... I>
+    inline auto ComponentArchetype<Ts...>::columns(const internal::archetype& a, size_type chunk,
+                                                   corsac::index_sequence<I...>) const noexcept
+    {
+        return corsac::tuple<Ts*...>(reinterpret_cast<Ts*>(a.chunk_column(a.first[id] + I, chunk))...);
+    }
+
+    /**
+     * ArchetypeView
+     *
+     * Обход ARCHETYPE компонентов по архетипам: подходят архетипы, сигнатура которых
+     * содержит все Components, сущности внутри идут подряд по чанкам.
+     *
+     * ArchetypeView<Position, Direction>().each([](auto ent, auto& x, auto& y, auto& dx, auto& dy) { ... });
+     *
+     * each_chunk отдает чанк целиком: f(count, const EntityType* ents, указатели на колонки...).
+     */
+    template<auto&... Components>
+    class ArchetypeView
+    {
+    public:
+        using size_type = size_t;
+
+        template<typename F>
+        void each_chunk(F&& f) const;
+
+        template<typename F>
+        void each(F&& f) const;
+
+        [[nodiscard]] size_type size() const noexcept;
+
+    private:
+        static internal::archetype_signature mask() noexcept;
+
+        template<typename Tuple, size_t... I>
+        static auto at(const Tuple& pointers, size_type n, corsac::index_sequence<I...>);
+    };
+
+    template<auto&... Components>
+    template<typename F>
+    inline void ArchetypeView<Components...>::each_chunk(F&& f) const
+    {
+        auto& world = internal::getArchetypeWorld();
+        const internal::archetype_signature m = mask();
+        for (size_type i = 0; i < world.size(); ++i)
+        {
+            const internal::archetype& a = world[i];
+            if ((a.signature & m) != m)
+                continue;
+            for (size_type c = 0; c < a.chunk_count(); ++c)
+            {
+                corsac::apply(f, corsac::tuple_cat(
+                        corsac::tuple<size_type, const EntityType*>(a.chunk_size(c),
+                                reinterpret_cast<const EntityType*>(a.chunk_column(0, c))),
+                        Components.columns(a, c)...));
+            }
+        }
+    }
+
+    template<auto&... Components>
+    template<typename F>
+    inline void ArchetypeView<Components...>::each(F&& f) const
+    {
+        each_chunk([&f](size_type count, const EntityType* entities, auto*... columns)
+        {
+            const auto pointers = corsac::tuple<decltype(columns)...>(columns...);
+            for (size_type n = 0; n < count; ++n)
+            {
+                corsac::apply(f, corsac::tuple_cat(corsac::tuple<EntityType>(entities[n]),
+                                                   at(pointers, n, corsac::index_sequence_for<decltype(columns)...>())));
+            }
+        });
+    }
+
+    template<auto&... Components>
+    inline typename ArchetypeView<Components...>::size_type ArchetypeView<Components...>::size() const noexcept
+    {
+        auto& world = internal::getArchetypeWorld();
+        const internal::archetype_signature m = mask();
+        size_type count = 0;
+        for (size_type i = 0; i < world.size(); ++i)
+        {
+            if ((world[i].signature & m) == m)
+                count += world[i].count;
+        }
+        return count;
+    }
+
+    template<auto&... Components>
+    inline internal::archetype_signature ArchetypeView<Components...>::mask() noexcept
+    {
+        return ((internal::archetype_signature(1) << Components.component_id()) | ... | internal::archetype_signature(0));
+    }
+
+    template<auto&... Components>
+    template<typename Tuple, size_t... I>
+    inline auto ArchetypeView<Components...>::at(const Tuple& pointers, size_type n, corsac::index_sequence<I...>)
+    {
+        return corsac::tuple<decltype(*corsac::get<I>(pointers))...>(corsac::get<I>(pointers)[n]...);
+    }
+}
+
+#endif //CORSAC_ECS_ARCHETYPE_H
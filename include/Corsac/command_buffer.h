@@ -0,0 +1,441 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_COMMAND_BUFFER_H
+#define CORSAC_ECS_COMMAND_BUFFER_H
+
+#include "Corsac/component.h"
+#include "Corsac/group.h"
+#include "Corsac/observer.h"
+#include "Corsac/thread_pool.h"
+#include "Corsac/tuple.h"
+#include "Corsac/vector.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace corsac
+{
+    namespace internal
+    {
+        // Выдача ID из буферов команд разных потоков.
+        inline std::mutex& getEntityAllocatorMutex() noexcept
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        enum CommandType : uint8_t
+        {
+            COMMAND_ADD,
+            COMMAND_SET,
+            COMMAND_FIT,
+            COMMAND_REMOVE
+        };
+
+        struct command_queue_base
+        {
+            const void* storage;
+
+            explicit command_queue_base(const void* s) noexcept : storage(s) {}
+            virtual ~command_queue_base() = default;
+
+            // Переносит команды x (того же хранилища) в конец очереди.
+            virtual void merge(command_queue_base& x) = 0;
+            virtual void apply() = 0;
+            virtual void clear() noexcept = 0;
+            [[nodiscard]] virtual size_t size() const noexcept = 0;
+        };
+
+        /**
+         * command_queue
+         *
+         * Команды одного хранилища. Значения хранятся в value_tuple хранилища,
+         * при применении команды упорядочиваются по индексу сущности с сохранением
+         * порядка команд одной сущности, поэтому sparse обходится по возрастанию.
+         * Сигналы Observed хранилища приходят одним пакетом на очередь.
+         */
+        template<typename Storage>
+        struct command_queue : public command_queue_base
+        {
+            using value_tuple = typename Storage::value_tuple;
+
+            struct command
+            {
+                EntityType  id;
+                CommandType type;
+                value_tuple values;
+            };
+
+            Storage&                storage;
+            corsac::vector<command> commands;
+
+            explicit command_queue(Storage& s) noexcept
+                : command_queue_base(&s), storage(s)
+            {}
+
+            template<typename... Args>
+            void push(const EntityType& id, CommandType type, Args&&... data)
+            {
+                commands.push_back(command{id, type, value_tuple(corsac::forward<Args>(data)...)});
+            }
+
+            void merge(command_queue_base& x) override
+            {
+                auto& other = static_cast<command_queue&>(x);
+                commands.reserve(commands.size() + other.commands.size());
+                for (auto& c : other.commands)
+                    commands.push_back(corsac::move(c));
+                other.commands.clear();
+            }
+
+            void apply() override
+            {
+                std::stable_sort(commands.begin(), commands.end(), [](const command& lhs, const command& rhs) {
+                    return entity_traits<EntityType>::index(lhs.id) < entity_traits<EntityType>::index(rhs.id);
+                });
+                internal::hold_signals(storage);
+                for (auto& c : commands)
+                {
+                    switch (c.type)
+                    {
+                        case COMMAND_ADD:
+                            corsac::apply([this, &c](auto&... data) { storage.add(c.id, data...); }, c.values);
+                            break;
+                        case COMMAND_SET:
+                            // У тегов и групп нет значений, set для них совпадает с add.
+                            if constexpr (Storage::component_type == GROUP || Storage::component_type == TAG)
+                                storage.add(c.id);
+                            else
+                                corsac::apply([this, &c](auto&... data) { storage.set(c.id, data...); }, c.values);
+                            break;
+                        case COMMAND_FIT:
+                            if constexpr (Storage::component_type != GROUP && Storage::component_type != TAG)
+                                corsac::apply([this, &c](auto&... data) { storage.fit(c.id, data...); }, c.values);
+                            break;
+                        case COMMAND_REMOVE:
+                            storage.remove(c.id);
+                            break;
+                    }
+                }
+                internal::release_signals(storage);
+                commands.clear();
+            }
+
+            void clear() noexcept override
+            {
+                commands.clear();
+            }
+
+            [[nodiscard]] size_t size() const noexcept override
+            {
+                return commands.size();
+            }
+        };
+    }
+
+    /**
+     * CommandBuffer
+     *
+     * Отложенные структурные изменения: add/set/fit/remove компонентов и групп,
+     * create/destroy сущностей. Команды копятся по хранилищам и применяются в flush(),
+     * каждое хранилище обрабатывается один раз, в порядке его первой команды.
+     * Уничтоженные сущности удаляются из всех хранилищ реестра и возвращаются
+     * в аллокатор после всех очередей.
+     *
+     * for (auto ent : W)
+     *     commands.fit<Direction>(ent, 0, -1).remove<W>(ent);
+     * commands.flush();
+     *
+     * Буфер не потокобезопасен, для параллельных систем - CommandBuffers.
+     */
+    class CommandBuffer
+    {
+        using queue_type = std::unique_ptr<internal::command_queue_base>;
+
+    public:
+        using size_type = size_t;
+
+    protected:
+        corsac::vector<queue_type> queues;
+        corsac::vector<EntityType> destroyed;
+
+    public:
+        CommandBuffer() noexcept = default;
+
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        template<auto& Component, typename ...Args>
+        CommandBuffer& add(const EntityType& value, Args&&... data);
+
+        template<auto& Component, typename ...Args>
+        CommandBuffer& set(const EntityType& value, Args&&... data);
+
+        template<auto& Component, typename ...Args>
+        CommandBuffer& fit(const EntityType& value, Args&&... data);
+
+        template<auto& Component>
+        CommandBuffer& remove(const EntityType& value);
+
+        // ID выдается сразу, в группы сущность попадает при flush().
+        template<auto& ...Group>
+        EntityType create();
+
+        template<auto& ...Group>
+        CommandBuffer& destroy(const EntityType& value);
+
+        // Переносит команды x в этот буфер, x остается пустым.
+        void merge(CommandBuffer& x);
+
+        void flush();
+
+        [[nodiscard]] bool      empty() const noexcept;
+        [[nodiscard]] size_type size() const noexcept;
+        void clear() noexcept;
+
+    private:
+        template<typename Storage>
+        internal::command_queue<Storage>& queue(Storage& storage);
+
+        internal::command_queue_base* find(const void* storage) const noexcept;
+    };
+
+    template<auto& Component, typename ...Args>
+    inline CommandBuffer& CommandBuffer::add(const EntityType& value, Args&&... data)
+    {
+        queue(Component).push(value, internal::COMMAND_ADD, corsac::forward<Args>(data)...);
+        return *this;
+    }
+
+    template<auto& Component, typename ...Args>
+    inline CommandBuffer& CommandBuffer::set(const EntityType& value, Args&&... data)
+    {
+        queue(Component).push(value, internal::COMMAND_SET, corsac::forward<Args>(data)...);
+        return *this;
+    }
+
+    template<auto& Component, typename ...Args>
+    inline CommandBuffer& CommandBuffer::fit(const EntityType& value, Args&&... data)
+    {
+        static_assert(corsac::remove_reference_t<decltype(Component)>::component_type != internal::GROUP
+                   && corsac::remove_reference_t<decltype(Component)>::component_type != internal::TAG,
+                      "CommandBuffer::fit - storage has no values");
+        queue(Component).push(value, internal::COMMAND_FIT, corsac::forward<Args>(data)...);
+        return *this;
+    }
+
+    template<auto& Component>
+    inline CommandBuffer& CommandBuffer::remove(const EntityType& value)
+    {
+        queue(Component).push(value, internal::COMMAND_REMOVE);
+        return *this;
+    }
+
+    template<auto& ...Group>
+    inline EntityType CommandBuffer::create()
+    {
+        EntityType value;
+        {
+            std::lock_guard<std::mutex> lock(internal::getEntityAllocatorMutex());
+            value = internal::getNewEntityTypeID();
+        }
+        (queue(Group).push(value, internal::COMMAND_ADD), ...);
+        return value;
+    }
+
+    template<auto& ...Group>
+    inline CommandBuffer& CommandBuffer::destroy(const EntityType& value)
+    {
+        (queue(Group).push(value, internal::COMMAND_REMOVE), ...);
+        destroyed.push_back(value);
+        return *this;
+    }
+
+    inline void CommandBuffer::merge(CommandBuffer& x)
+    {
+        for (auto& q : x.queues)
+        {
+            if (auto* own = find(q->storage))
+                own->merge(*q);
+            else
+                queues.push_back(corsac::move(q));
+        }
+        x.queues.clear();
+        destroyed.insert(destroyed.end(), x.destroyed.begin(), x.destroyed.end());
+        x.destroyed.clear();
+    }
+
+    inline void CommandBuffer::flush()
+    {
+        for (auto& q : queues)
+            q->apply();
+        if (!destroyed.empty())
+        {
+            std::lock_guard<std::mutex> lock(internal::getEntityAllocatorMutex());
+            for (const EntityType& value : destroyed)
+            {
+                internal::getRegistry().destroy(value);
+                internal::getEntityAllocator().destroy(value);
+            }
+            destroyed.clear();
+        }
+    }
+
+    inline bool CommandBuffer::empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    inline CommandBuffer::size_type CommandBuffer::size() const noexcept
+    {
+        size_type count = destroyed.size();
+        for (const auto& q : queues)
+            count += q->size();
+        return count;
+    }
+
+    inline void CommandBuffer::clear() noexcept
+    {
+        for (auto& q : queues)
+            q->clear();
+        destroyed.clear();
+    }
+
+    template<typename Storage>
+    inline internal::command_queue<Storage>& CommandBuffer::queue(Storage& storage)
+    {
+        if (auto* q = find(&storage))
+            return static_cast<internal::command_queue<Storage>&>(*q);
+        queues.push_back(queue_type(new internal::command_queue<Storage>(storage)));
+        return static_cast<internal::command_queue<Storage>&>(*queues.back());
+    }
+
+    inline internal::command_queue_base* CommandBuffer::find(const void* storage) const noexcept
+    {
+        // Хранилищ в буфере единицы, линейный поиск дешевле хеширования.
+        for (const auto& q : queues)
+        {
+            if (q->storage == storage)
+                return q.get();
+        }
+        return nullptr;
+    }
+
+    /**
+     * CommandBuffers
+     *
+     * По буферу на каждый поток пула и на поток, создавший буферы, запись идет без блокировок.
+     * Остальные потоки (например, потоки другого пула) получают свой буфер при первом local()
+     * под мьютексом, дальше пишут в него без блокировок.
+     * flush() сливает буферы в порядке номеров потоков, затем буферы чужих потоков
+     * в порядке их появления и применяет их одним проходом.
+     *
+     * corsac::System(Unit, pool, [&commands](auto ent, auto&...) {
+     *     commands.local().remove<W>(ent);
+     * });
+     * commands.flush();
+     */
+    class CommandBuffers
+    {
+    public:
+        using size_type = size_t;
+
+    protected:
+        struct foreign_buffer
+        {
+            std::thread::id                thread;
+            std::unique_ptr<CommandBuffer> buffer;
+        };
+
+        std::unique_ptr<CommandBuffer[]> buffers;
+        size_type                        count;
+        const ThreadPool*                owner;
+        std::thread::id                  creator;
+        corsac::vector<foreign_buffer>   foreign;
+        std::mutex                       foreignMutex;
+
+        CommandBuffer& foreign_local();
+
+    public:
+        explicit CommandBuffers(const ThreadPool& pool);
+
+        // Буфер текущего потока.
+        CommandBuffer& local();
+        CommandBuffer& operator[](size_type n) noexcept;
+
+        void flush();
+
+        [[nodiscard]] size_type size() const noexcept;
+        void clear() noexcept;
+    };
+
+    inline CommandBuffers::CommandBuffers(const ThreadPool& pool)
+        : buffers(new CommandBuffer[pool.size() + 1]), count(pool.size() + 1), owner(&pool),
+          creator(std::this_thread::get_id())
+    {}
+
+    inline CommandBuffer& CommandBuffers::local()
+    {
+        if (owner->owns_current_thread())
+        {
+            const size_type index = ThreadPool::current_index();
+        #if CORSAC_ASSERT_ENABLED
+            if (CORSAC_UNLIKELY(index >= count))
+                CORSAC_FAIL_MSG("CommandBuffers::local -- thread index out of range");
+        #endif
+            return buffers[index];
+        }
+        if (std::this_thread::get_id() == creator)
+            return buffers[0];
+        // Номер потока чужого пула не относится к этим буферам.
+        return foreign_local();
+    }
+
+    inline CommandBuffer& CommandBuffers::foreign_local()
+    {
+        const std::thread::id thread = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(foreignMutex);
+        for (foreign_buffer& f : foreign)
+        {
+            if (f.thread == thread)
+                return *f.buffer;
+        }
+        foreign.push_back(foreign_buffer{thread, std::make_unique<CommandBuffer>()});
+        return *foreign.back().buffer;
+    }
+
+    inline CommandBuffer& CommandBuffers::operator[](size_type n) noexcept
+    {
+        return buffers[n];
+    }
+
+    inline void CommandBuffers::flush()
+    {
+        for (size_type i = 1; i < count; ++i)
+            buffers[0].merge(buffers[i]);
+        std::lock_guard<std::mutex> lock(foreignMutex);
+        for (foreign_buffer& f : foreign)
+            buffers[0].merge(*f.buffer);
+        buffers[0].flush();
+    }
+
+    inline CommandBuffers::size_type CommandBuffers::size() const noexcept
+    {
+        return count;
+    }
+
+    inline void CommandBuffers::clear() noexcept
+    {
+        for (size_type i = 0; i < count; ++i)
+            buffers[i].clear();
+        std::lock_guard<std::mutex> lock(foreignMutex);
+        for (foreign_buffer& f : foreign)
+            f.buffer->clear();
+    }
+}
+
+#endif //CORSAC_ECS_COMMAND_BUFFER_H
@@ -6,12 +6,14 @@
 #define CORSAC_ECS_COMPONENT_H
 
 #include "Corsac/sparse_set.h"
+#include "Corsac/aligned_vector.h"
+#include "Corsac/mapped_vector.h"
+#include "Corsac/tick.h"
 #include "Corsac/type_traits.h"
+#include "Corsac/tuple.h"
 
 namespace corsac
 {
-    using EntityType = uint32_t;
-
     /**
      * ComponentContainerType
      *
@@ -20,13 +22,23 @@ namespace corsac
      *      DYNAMIC - Память под данные выделяться динамически в heap.
      *      FIXED   - Память под данные выделяеться заранее в stack, но преодоление лимита будет увеличена емкость в heap.
      *      STATIC  - Память под данные выделяеться заранее в stack, расширение не возможно.
+     *      ALIGNED - Как DYNAMIC, но каждая колонка выровнена по CORSAC_ECS_COLUMN_ALIGNMENT байт,
+     *                а емкость кратна CORSAC_ECS_SIMD_WIDTH элементам. Хвост за size() заполнен T().
+     *      ARCHETYPE - Данные лежат в чанках архетипов вместе с другими ARCHETYPE компонентами сущности,
+     *                  обход через ArchetypeView (Corsac/archetype.h).
+     *      MAPPED  - Как DYNAMIC, но packed и колонки лежат в отображенной памяти (Corsac/mapped_vector.h).
+     *                После open(path) они живут в файлах и переживают перезапуск, sparse строится при открытии.
+     *                Значения должны быть тривиально копируемыми.
      */
     enum ComponentContainerType
     {
         SINGLE,
         DYNAMIC,
         FIXED,
-        STATIC
+        STATIC,
+        ALIGNED,
+        ARCHETYPE,
+        MAPPED
     };
 
     namespace internal
@@ -35,7 +47,9 @@ namespace corsac
         {
             AOS,
             SOA,
-            TAG
+            TAG,
+            GROUP,
+            CHUNK
         };
 
         template<ComponentContainerType C, size_t nodeCount, typename... Ts>
@@ -71,21 +85,50 @@ namespace corsac
             >;
             static_assert(!corsac::is_same_v<value, corsac::false_type>, "Invalid template argument!");
         };
+
+        // copy_values для каждой колонки tuple_vector, начиная с позиции pos.
+        template<typename Values, typename size_type, size_t... I, typename... Ts>
+        inline void copy_columns(Values& values, size_type pos, size_type n,
+                                 corsac::index_sequence<I...>, const Ts*... data)
+        {
+            (copy_values(data, n, values.template get<I>() + pos), ...);
+        }
+
+        // Колонки tuple_vector в снимок и обратно, по блоку на колонку.
+        template<typename Values, typename size_type, size_t... I>
+        inline void write_columns(Snapshot& out, const Values& values, size_type n, corsac::index_sequence<I...>)
+        {
+            (out.write(values.template get<I>(), n * sizeof(*values.template get<I>())), ...);
+        }
+
+        template<typename Values, typename size_type, size_t... I>
+        inline void read_columns(Snapshot& in, Values& values, size_type n, corsac::index_sequence<I...>)
+        {
+            (in.read(values.template get<I>(), n * sizeof(*values.template get<I>())), ...);
+        }
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    class ComponentAoS : public sparse_set<EntityType, nodeCount, C != STATIC>
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator = internal::default_allocator>
+    class ComponentAoS : public sparse_set<EntityType, nodeCount, C != STATIC, CORSAC_ECS_SPARSE_PAGE_SIZE, C == MAPPED, Allocator>
     {
         using Values = corsac::conditional_t<
                 C == DYNAMIC,
-                corsac::vector<T>,
+                corsac::vector<T, Allocator>,
                 corsac::conditional_t<
                         C == FIXED,
-                        corsac::fixed_vector<T, nodeCount, true>,
+                        corsac::fixed_vector<T, nodeCount, true, Allocator>,
                         corsac::conditional_t<
                                 C == STATIC,
-                                corsac::fixed_vector<T, nodeCount, false>,
-                                corsac::false_type
+                                corsac::fixed_vector<T, nodeCount, false, Allocator>,
+                                corsac::conditional_t<
+                                        C == ALIGNED,
+                                        internal::aligned_vector<T, CORSAC_ECS_COLUMN_ALIGNMENT, CORSAC_ECS_SIMD_WIDTH>,
+                                        corsac::conditional_t<
+                                                C == MAPPED,
+                                                internal::mapped_vector<T>,
+                                                corsac::false_type
+                                        >
+                                >
                         >
                 >
         >;
@@ -94,7 +137,7 @@ namespace corsac
                 "ComponentAoS<ComponentContainerType> - invalid template argument"
         );
 
-        using base_type                 = sparse_set<EntityType, nodeCount, C != STATIC>;
+        using base_type                 = sparse_set<EntityType, nodeCount, C != STATIC, CORSAC_ECS_SPARSE_PAGE_SIZE, C == MAPPED, Allocator>;
         using size_type                 = typename base_type::size_type;
         using pointer                   = T*;
         using const_pointer             = const T*;
@@ -110,9 +153,20 @@ namespace corsac
         using base_type::packed;
         using base_type::sparse;
         using base_type::has;
+        using base_type::index;
+
+        static constexpr internal::ComponentType component_type = internal::AOS;
+
+        using value_tuple = corsac::tuple<T>;
 
     protected:
-        Values values;
+        using base_type::entry;
+    #if CORSAC_ECS_STATS
+        using base_type::stats;
+    #endif
+
+        Values                 values;
+        internal::change_ticks<Allocator> ticks;
 
     public:
         ComponentAoS() noexcept;
@@ -150,6 +204,9 @@ namespace corsac
         pointer       data() noexcept;
         const_pointer data() const noexcept;
 
+        // Длина колонок для ядер: size(), в режиме ALIGNED округленный до CORSAC_ECS_SIMD_WIDTH.
+        [[nodiscard]] size_type padded_size() const noexcept;
+
         reference       get(const EntityType& value);
         reference       get(EntityType&& value);
         const_reference get(const EntityType& value) const;
@@ -160,6 +217,10 @@ namespace corsac
         void add(const EntityType& value, const value_type& data) noexcept;
         void add(EntityType&& value, value_type&& data) noexcept;
 
+        // Пакетное добавление: ids[i] получает data[i], уже добавленные сущности пропускаются.
+        size_type add_n(const EntityType* ids, size_type n);
+        size_type add_n(const EntityType* ids, size_type n, const value_type* data);
+
         void set(const EntityType& value) noexcept;
         void set(EntityType&& value) noexcept;
         void set(const EntityType& value, const value_type& data) noexcept;
@@ -173,115 +234,162 @@ namespace corsac
         void remove(const EntityType& value) noexcept;
         void remove(EntityType&& value) noexcept;
 
+        void swap_at(size_type lhs, size_type rhs) noexcept;
+
+        // Сортирует сущности вместе со значениями, compare(lhs, rhs) сравнивает значения.
+        template<typename Compare>
+        void sort(Compare compare);
+
+        // Устойчивая поразрядная сортировка по целому ключу key(value).
+        template<typename Key>
+        void sort_by_key(Key key);
+
+        // Общие с other сущности встают в начало packed в порядке other, значения едут следом.
+        template<typename Other>
+        void sort_as(const Other& other);
+
         void clear() noexcept;
         void reset_lose_memory() noexcept;
+
+        // Память sparse_set, значений и тиков изменений.
+        [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
+        // Снимок packed и значений одним блоком, значения должны быть тривиально копируемыми.
+        // После restore учет изменений считает все сущности измененными в текущем тике.
+        void snapshot(Snapshot& out) const;
+        bool restore(Snapshot& in);
+
+        // only MAPPED
+        // Отображает packed в файл "path.packed", значения - в "path.values". Записанные не до
+        // конца файлы обрезаются до общей длины. Оба файла проверяются до отображения: если
+        // один чужой или не открылся, false, файлы не меняются, а хранилище остается в памяти
+        // с прежним содержимым. ID из файлов аллокатор сущностей не резервирует: его нужно
+        // восстановить из своего снимка (Corsac/snapshot.h) до выдачи новых ID.
+        bool open(const char* path);
+        void sync() noexcept;
+
+        // Учет изменений: add/set/fit и изменяемый get() отмечают сущность текущим тиком.
+        void track_changes(bool enable = true);
+        [[nodiscard]] bool tracking() const noexcept;
+
+        [[nodiscard]] Tick added_at(const EntityType& value) const noexcept;
+        [[nodiscard]] Tick changed_at(const EntityType& value) const noexcept;
+
+        // Без учета изменений любая сущность считается измененной.
+        [[nodiscard]] bool added_since(const EntityType& value, Tick tick) const noexcept;
+        [[nodiscard]] bool changed_since(const EntityType& value, Tick tick) const noexcept;
+
+        // Отмечает изменение в обход get(): через data(), итераторы или View.
+        void touch(const EntityType& value) noexcept;
     };
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline ComponentAoS<C, nodeCount, T>::ComponentAoS() noexcept
-        = default;
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline ComponentAoS<C, nodeCount, T, Allocator>::ComponentAoS() noexcept
+    {
+        entry.enroll(this);
+    }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::iterator
-    ComponentAoS<C, nodeCount, T>::begin() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::begin() noexcept
     {
         return values.begin();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_iterator
-    ComponentAoS<C, nodeCount, T>::begin() const noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::begin() const noexcept
     {
         return values.begin();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::iterator
-    ComponentAoS<C, nodeCount, T>::end() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::end() noexcept
     {
         return values.end();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_iterator
-    ComponentAoS<C, nodeCount, T>::end() const noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::end() const noexcept
     {
         return values.end();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reverse_iterator
-    ComponentAoS<C, nodeCount, T>::rbegin() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reverse_iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::rbegin() noexcept
     {
         return values.rbegin();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reverse_iterator
-    ComponentAoS<C, nodeCount, T>::rbegin() const noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reverse_iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::rbegin() const noexcept
     {
         return values.rbegin();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reverse_iterator
-    ComponentAoS<C, nodeCount, T>::rend() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reverse_iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::rend() noexcept
     {
         return values.rend();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reverse_iterator
-    ComponentAoS<C, nodeCount, T>::rend() const noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reverse_iterator
+    ComponentAoS<C, nodeCount, T, Allocator>::rend() const noexcept
     {
         return values.rend();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reference
-    ComponentAoS<C, nodeCount, T>::front()
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reference
+    ComponentAoS<C, nodeCount, T, Allocator>::front()
     {
         return values.front();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reference
-    ComponentAoS<C, nodeCount, T>::front() const
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reference
+    ComponentAoS<C, nodeCount, T, Allocator>::front() const
     {
         return values.front();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reference
-    ComponentAoS<C, nodeCount, T>::back()
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reference
+    ComponentAoS<C, nodeCount, T, Allocator>::back()
     {
         return values.back();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reference
-    ComponentAoS<C, nodeCount, T>::back() const
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reference
+    ComponentAoS<C, nodeCount, T, Allocator>::back() const
     {
         return values.back();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reference
-    ComponentAoS<C, nodeCount, T>::at(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reference
+    ComponentAoS<C, nodeCount, T, Allocator>::at(size_type n)
     {
         return n < packed.size() ? values[n] : nullptr;
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reference
-    ComponentAoS<C, nodeCount, T>::at(size_type n) const
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reference
+    ComponentAoS<C, nodeCount, T, Allocator>::at(size_type n) const
     {
         return n < packed.size() ? values[n] : nullptr;
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reference
-    ComponentAoS<C, nodeCount, T>::operator[](size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reference
+    ComponentAoS<C, nodeCount, T, Allocator>::operator[](size_type n)
     {
         #if CORSAC_EXCEPTIONS_ENABLED
             if(CORSAC_UNLIKELY(n < packed.size()))
@@ -293,9 +401,9 @@ namespace corsac
         return values[n];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reference
-    ComponentAoS<C, nodeCount, T>::operator[](size_type n) const
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reference
+    ComponentAoS<C, nodeCount, T, Allocator>::operator[](size_type n) const
     {
         #if CORSAC_EXCEPTIONS_ENABLED
             if(CORSAC_UNLIKELY(n < packed.size()))
@@ -307,233 +415,317 @@ namespace corsac
         return values[n];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::resize(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::resize(size_type n)
     {
         packed.resize(n);
         sparse.resize(n);
         values.resize(n);
+        ticks.resize(n);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::reserve(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::reserve(size_type n)
     {
         packed.reserve(n);
         sparse.reserve(n);
         values.reserve(n);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::set_capacity(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::set_capacity(size_type n)
     {
         packed.set_capacity(n);
         sparse.set_capacity(n);
         values.set_capacity(n);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::shrink_to_fit()
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::shrink_to_fit()
     {
         packed.shrink_to_fit();
-        sparse.shrink_to_fit();
+        sparse.release_unused(packed.begin(), packed.end());
         values.shrink_to_fit();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::pointer
-    ComponentAoS<C, nodeCount, T>::data() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::pointer
+    ComponentAoS<C, nodeCount, T, Allocator>::data() noexcept
     {
         return values.data();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_pointer
-    ComponentAoS<C, nodeCount, T>::data() const noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_pointer
+    ComponentAoS<C, nodeCount, T, Allocator>::data() const noexcept
     {
         return values.data();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reference
-    ComponentAoS<C, nodeCount, T>::get(const EntityType& value)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::size_type
+    ComponentAoS<C, nodeCount, T, Allocator>::padded_size() const noexcept
+    {
+        if constexpr (C == ALIGNED)
+            return values.padded_size();
+        else
+            return packed.size();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reference
+    ComponentAoS<C, nodeCount, T, Allocator>::get(const EntityType& value)
     {
         #if CORSAC_EXCEPTIONS_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 throw std::out_of_range("ComponentAoS::get -- out of range");
         #elif CORSAC_ASSERT_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 CORSAC_FAIL_MSG("ComponentAoS::get -- out of range");
         #endif
+        ticks.touch(sparse[value]);
         return values[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::reference
-    ComponentAoS<C, nodeCount, T>::get(EntityType&& value)
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::reference
+    ComponentAoS<C, nodeCount, T, Allocator>::get(EntityType&& value)
     {
         #if CORSAC_EXCEPTIONS_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 throw std::out_of_range("ComponentAoS::get -- out of range");
         #elif CORSAC_ASSERT_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 CORSAC_FAIL_MSG("ComponentAoS::get -- out of range");
         #endif
+        ticks.touch(sparse[value]);
         return values[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reference
-    ComponentAoS<C, nodeCount, T>::get(const EntityType& value) const
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reference
+    ComponentAoS<C, nodeCount, T, Allocator>::get(const EntityType& value) const
     {
         #if CORSAC_EXCEPTIONS_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 throw std::out_of_range("ComponentAoS::get -- out of range");
         #elif CORSAC_ASSERT_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 CORSAC_FAIL_MSG("ComponentAoS::get -- out of range");
         #endif
         return values[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline typename ComponentAoS<C, nodeCount, T>::const_reference
-    ComponentAoS<C, nodeCount, T>::get(EntityType&& value) const
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::const_reference
+    ComponentAoS<C, nodeCount, T, Allocator>::get(EntityType&& value) const
     {
         #if CORSAC_EXCEPTIONS_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 throw std::out_of_range("ComponentAoS::get -- out of range");
         #elif CORSAC_ASSERT_ENABLED
-            if(CORSAC_UNLIKELY(value >= sparse.size()))
+            if(CORSAC_UNLIKELY(!sparse.contains(value)))
                 CORSAC_FAIL_MSG("ComponentAoS::get -- out of range");
         #endif
         return values[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::add(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::add(const EntityType &value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::add(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::add(EntityType &&value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::add(const EntityType &value, const value_type &data) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::add(const EntityType &value, const value_type &data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back(data);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::add(EntityType &&value, value_type &&data) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::add(EntityType &&value, value_type &&data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back(corsac::move(data));
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::set(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::size_type
+    ComponentAoS<C, nodeCount, T, Allocator>::add_n(const EntityType* ids, size_type n)
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        const size_type added = base_type::add_n(ids, n);
+        values.resize(packed.size());
+        CORSAC_ECS_STATS_VALUES_N(stats, values, packed.size() - added, sizeof(T));
+        ticks.resize(packed.size());
+        return added;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline typename ComponentAoS<C, nodeCount, T, Allocator>::size_type
+    ComponentAoS<C, nodeCount, T, Allocator>::add_n(const EntityType* ids, size_type n, const value_type* data)
+    {
+        const size_type count = packed.size();
+        const size_type added = base_type::add_n(ids, n);
+        if (added == n)
+        {
+            values.resize(count + n);
+            CORSAC_ECS_STATS_VALUES_N(stats, values, count, sizeof(T));
+            internal::copy_values(data, n, values.data() + count);
+            ticks.resize(packed.size());
+            return added;
+        }
+        // Новые сущности легли в packed в порядке ids, пропущенные в packed не попали.
+        values.reserve(count + added);
+        CORSAC_ECS_STATS_VALUES_N(stats, values, count, sizeof(T));
+        for (size_type i = 0, j = count; i < n && j < packed.size(); ++i)
+        {
+            if (packed[j] == ids[i])
+            {
+                values.push_back(data[i]);
+                ++j;
+            }
+        }
+        ticks.resize(packed.size());
+        return added;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::set(const EntityType &value) noexcept
+    {
+        if (has(value))
+        {
             get(value) = T();
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::set(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::set(EntityType &&value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
             get(corsac::move(value)) = T();
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::set(const EntityType &value, const value_type &data) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::set(const EntityType &value, const value_type &data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
             get(value) = T(data);
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back(data);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::set(EntityType &&value, value_type &&data) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::set(EntityType &&value, value_type &&data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
             get(corsac::move(value)) = T(corsac::move(data));
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back(corsac::move(data));
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, sizeof(T));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::fit(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::fit(const EntityType &value) noexcept
     {
         get(value) = T();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::fit(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::fit(EntityType &&value) noexcept
     {
         get(corsac::move(value)) = T();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::fit(const EntityType &value, const value_type &data) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::fit(const EntityType &value, const value_type &data) noexcept
     {
         get(value) = T(data);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::fit(EntityType &&value, value_type &&data) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::fit(EntityType &&value, value_type &&data) noexcept
     {
         get(corsac::move(value)) = T(corsac::move(data));
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::remove(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::remove(const EntityType &value) noexcept
     {
         if (has(value))
         {
+            ticks.erase(sparse[value]);
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(EntityType) + sizeof(T));
+            entry.reset(value);
             packed[sparse[value]] = packed.back();
             values[sparse[value]] = values.back();
             sparse[packed.back()] = sparse[value];
@@ -542,11 +734,14 @@ namespace corsac
         }
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::remove(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::remove(EntityType &&value) noexcept
     {
         if (has(value))
         {
+            ticks.erase(sparse[value]);
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(EntityType) + sizeof(T));
+            entry.reset(value);
             packed[sparse[value]] = packed.back();
             values[sparse[value]] = values.back();
             sparse[packed.back()] = sparse[value];
@@ -555,51 +750,227 @@ namespace corsac
         }
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::clear() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::swap_at(size_type lhs, size_type rhs) noexcept
+    {
+        base_type::swap_at(lhs, rhs);
+        ticks.swap(lhs, rhs);
+        corsac::swap(values[lhs], values[rhs]);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    template<typename Compare>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::sort(Compare compare)
     {
+        auto order = internal::sort_order(packed.size(), [this, &compare](size_type lhs, size_type rhs) {
+            return compare(static_cast<const T&>(values[lhs]), static_cast<const T&>(values[rhs]));
+        });
+        internal::permute(*this, order);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    template<typename Key>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::sort_by_key(Key key)
+    {
+        auto order = internal::radix_order(packed.size(), [this, &key](size_type pos) {
+            return key(static_cast<const T&>(values[pos]));
+        });
+        internal::permute(*this, order);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    template<typename Other>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::sort_as(const Other& other)
+    {
+        internal::sort_as(*this, other);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::clear() noexcept
+    {
+        entry.reset(packed.begin(), packed.end());
         packed.clear();
         sparse.clear();
         values.clear();
+        ticks.clear();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename T>
-    inline void ComponentAoS<C, nodeCount, T>::reset_lose_memory() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::reset_lose_memory() noexcept
     {
-        packed.reset_lose_memory();
+        base_type::reset_lose_memory();
         values.reset_lose_memory();
+        ticks.reset_lose_memory();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline MemoryUsage ComponentAoS<C, nodeCount, T, Allocator>::memory_usage() const noexcept
+    {
+        MemoryUsage usage = base_type::memory_usage();
+        usage.values_used     = static_cast<size_t>(values.size()) * sizeof(T);
+        usage.values_capacity = static_cast<size_t>(values.capacity()) * sizeof(T);
+        usage += ticks.memory_usage();
+        return usage;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::snapshot(Snapshot& out) const
+    {
+        static_assert(corsac::is_trivially_copyable<T>::value,
+                      "ComponentAoS::snapshot - values must be trivially copyable");
+        constexpr uint32_t stride = static_cast<uint32_t>(sizeof(EntityType) + sizeof(T));
+        out.write_header(internal::SNAPSHOT_AOS, packed.size(), 1, stride);
+        base_type::write_packed(out);
+        out.write(values.data(), packed.size() * sizeof(T));
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline bool ComponentAoS<C, nodeCount, T, Allocator>::restore(Snapshot& in)
+    {
+        static_assert(corsac::is_trivially_copyable<T>::value,
+                      "ComponentAoS::restore - values must be trivially copyable");
+        constexpr uint32_t stride = static_cast<uint32_t>(sizeof(EntityType) + sizeof(T));
+        const size_type n = in.read_header(internal::SNAPSHOT_AOS, 1, stride);
+        if (n == Snapshot::npos)
+            return false;
+        base_type::read_packed(in, n);
+        values.resize(n);
+        in.read(values.data(), n * sizeof(T));
+        ticks.clear();
+        ticks.resize(n);
+        return true;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline bool ComponentAoS<C, nodeCount, T, Allocator>::open(const char* path)
+    {
+        static_assert(C == MAPPED, "ComponentAoS::open -- not mapped");
+        const std::string packedPath = std::string(path) + ".packed";
+        const std::string valuesPath = std::string(path) + ".values";
+        if (!base_type::accepts(packedPath.c_str()) || !Values::accepts(valuesPath.c_str()))
+            return false;
+        // Снимок содержимого в памяти: если файлы отобразятся не все, хранилище возвращается к нему.
+        const corsac::vector<EntityType> previousPacked(packed.begin(), packed.end());
+        Values previousValues(values);
+        const bool opened = base_type::open(packedPath.c_str()) && values.open(valuesPath.c_str());
+        if (!opened)
+        {
+            base_type::close();
+            values.close();
+            values = corsac::move(previousValues);
+            base_type::assign_packed(previousPacked.data(), previousPacked.size());
+        }
+        while (packed.size() > values.size())
+            base_type::remove(EntityType(packed.back()));
+        values.resize(packed.size());
+        ticks.clear();
+        ticks.resize(packed.size());
+        return opened;
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    class ComponentSoA : public sparse_set<EntityType, nodeCount, !(C == STATIC)>
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::sync() noexcept
     {
+        static_assert(C == MAPPED, "ComponentAoS::sync -- not mapped");
+        base_type::sync();
+        values.sync();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::track_changes(bool enable)
+    {
+        if (enable)
+            ticks.enable(packed.size());
+        else
+            ticks.disable();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline bool ComponentAoS<C, nodeCount, T, Allocator>::tracking() const noexcept
+    {
+        return ticks.tracking();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline Tick ComponentAoS<C, nodeCount, T, Allocator>::added_at(const EntityType& value) const noexcept
+    {
+        return has(value) ? ticks.added_at(sparse[value]) : 0;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline Tick ComponentAoS<C, nodeCount, T, Allocator>::changed_at(const EntityType& value) const noexcept
+    {
+        return has(value) ? ticks.changed_at(sparse[value]) : 0;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline bool ComponentAoS<C, nodeCount, T, Allocator>::added_since(const EntityType& value, Tick tick) const noexcept
+    {
+        return !ticks.tracking() || added_at(value) >= tick;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline bool ComponentAoS<C, nodeCount, T, Allocator>::changed_since(const EntityType& value, Tick tick) const noexcept
+    {
+        return !ticks.tracking() || changed_at(value) >= tick;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename T, typename Allocator>
+    inline void ComponentAoS<C, nodeCount, T, Allocator>::touch(const EntityType& value) noexcept
+    {
+        if (has(value))
+            ticks.touch(sparse[value]);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    class ComponentSoA : public sparse_set<EntityType, nodeCount, !(C == STATIC), CORSAC_ECS_SPARSE_PAGE_SIZE, C == MAPPED, Allocator>
+    {
+        // fixed_tuple_vector не принимает аллокатор: переполнение FIXED колонок идет через аллокатор по умолчанию.
         using Values = corsac::conditional_t<
             C == DYNAMIC,
-            corsac::tuple_vector<Ts...>,
+            corsac::tuple_vector_alloc<Allocator, Ts...>,
             corsac::conditional_t<
                 C == FIXED,
                 corsac::fixed_tuple_vector<nodeCount, true, Ts...>,
                 corsac::conditional_t<
                     C == STATIC,
                     corsac::fixed_tuple_vector<nodeCount, false, Ts...>,
-                    corsac::false_type
+                    corsac::conditional_t<
+                        C == ALIGNED,
+                        internal::aligned_tuple_vector<CORSAC_ECS_COLUMN_ALIGNMENT, CORSAC_ECS_SIMD_WIDTH, Ts...>,
+                        corsac::conditional_t<
+                            C == MAPPED,
+                            internal::mapped_tuple_vector<Ts...>,
+                            corsac::false_type
+                        >
+                    >
                 >
             >
         >;
         static_assert(!is_same_v<Values, corsac::false_type>,
                       "ComponentSoA<ComponentContainerType> - invalid template argument");
 
-        using base_type                 = sparse_set<EntityType, nodeCount, !(C == STATIC)>;
+        using base_type                 = sparse_set<EntityType, nodeCount, !(C == STATIC), CORSAC_ECS_SPARSE_PAGE_SIZE, C == MAPPED, Allocator>;
         using size_type                 = typename base_type::size_type;
 
     public:
         using base_type::packed;
         using base_type::sparse;
         using base_type::has;
+        using base_type::index;
         Values values;
 
+        static constexpr internal::ComponentType component_type = internal::SOA;
+
+        using value_tuple = corsac::tuple<Ts...>;
+
     protected:
+        using base_type::entry;
+    #if CORSAC_ECS_STATS
+        using base_type::stats;
+    #endif
 
+        internal::change_ticks<Allocator> ticks;
 
     public:
         ComponentSoA() noexcept;
@@ -617,16 +988,16 @@ namespace corsac
         auto get() const;
 
         template<size_t I>
-        auto get(const EntityType& value);
+        auto& get(const EntityType& value);
 
         template<size_t I>
-        auto get(EntityType&& value);
+        auto& get(EntityType&& value);
 
         template<size_t I>
-        auto get(const EntityType& value) const;
+        const auto& get(const EntityType& value) const;
 
         template<size_t I>
-        auto get(EntityType&& value) const;
+        const auto& get(EntityType&& value) const;
 
         auto operator[](size_type n);
         auto operator[](size_type n) const;
@@ -640,6 +1011,9 @@ namespace corsac
         auto data() noexcept;
         auto data() const noexcept;
 
+        // Длина колонок для ядер: size(), в режиме ALIGNED округленный до CORSAC_ECS_SIMD_WIDTH.
+        [[nodiscard]] size_type padded_size() const noexcept;
+
         void add(const EntityType& value) noexcept;
         void add(EntityType&& value) noexcept;
 
@@ -649,6 +1023,10 @@ namespace corsac
         template<typename ...Args>
         void add(EntityType&& value, Args&&... data) noexcept;
 
+        // Пакетное добавление, по указателю на n значений для каждой колонки.
+        size_type add_n(const EntityType* ids, size_type n);
+        size_type add_n(const EntityType* ids, size_type n, const Ts*... data);
+
         void set(const EntityType& value) noexcept;
         void set(EntityType&& value) noexcept;
 
@@ -670,267 +1048,405 @@ namespace corsac
         void remove(const EntityType& value) noexcept;
         void remove(EntityType&& value) noexcept;
 
+        void swap_at(size_type lhs, size_type rhs) noexcept;
+
+        // Сортирует сущности вместе со значениями, compare(lhs, rhs) сравнивает строки tuple<Ts&...>.
+        template<typename Compare>
+        void sort(Compare compare);
+
+        // Устойчивая поразрядная сортировка по целому ключу key(const Ts&...).
+        template<typename Key>
+        void sort_by_key(Key key);
+
+        // Общие с other сущности встают в начало packed в порядке other, значения едут следом.
+        template<typename Other>
+        void sort_as(const Other& other);
+
         void clear() noexcept;
         void reset_lose_memory() noexcept;
+
+        // Память sparse_set, значений и тиков изменений.
+        [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
+        // Снимок packed и значений одним блоком, значения должны быть тривиально копируемыми.
+        // После restore учет изменений считает все сущности измененными в текущем тике.
+        void snapshot(Snapshot& out) const;
+        bool restore(Snapshot& in);
+
+        // only MAPPED
+        // Отображает packed в файл "path.packed", колонку I - в "path.I". Записанные не до
+        // конца файлы обрезаются до общей длины. Все файлы проверяются до отображения: если
+        // один чужой или не открылся, false, файлы не меняются, а хранилище остается в памяти
+        // с прежним содержимым. ID из файлов аллокатор сущностей не резервирует: его нужно
+        // восстановить из своего снимка (Corsac/snapshot.h) до выдачи новых ID.
+        bool open(const char* path);
+        void sync() noexcept;
+
+        // Учет изменений: add/set/fit и изменяемый get() отмечают сущность текущим тиком.
+        void track_changes(bool enable = true);
+        [[nodiscard]] bool tracking() const noexcept;
+
+        [[nodiscard]] Tick added_at(const EntityType& value) const noexcept;
+        [[nodiscard]] Tick changed_at(const EntityType& value) const noexcept;
+
+        // Без учета изменений любая сущность считается измененной.
+        [[nodiscard]] bool added_since(const EntityType& value, Tick tick) const noexcept;
+        [[nodiscard]] bool changed_since(const EntityType& value, Tick tick) const noexcept;
+
+        // Отмечает изменение в обход get(): через data(), итераторы или View.
+        void touch(const EntityType& value) noexcept;
     };
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline ComponentSoA<C, nodeCount, Ts...>::ComponentSoA() noexcept
-            = default;
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline ComponentSoA<C, nodeCount, Allocator, Ts...>::ComponentSoA() noexcept
+    {
+        entry.enroll(this);
+    }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    auto ComponentSoA<C, nodeCount, Ts...>::front()
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::front()
     {
         return values.front();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    auto ComponentSoA<C, nodeCount, Ts...>::front() const
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::front() const
     {
         return values.front();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    auto ComponentSoA<C, nodeCount, Ts...>::back()
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::back()
     {
         return values.back();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    auto ComponentSoA<C, nodeCount, Ts...>::back() const
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::back() const
     {
         return values.back();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<size_t I>
-    auto ComponentSoA<C, nodeCount, Ts...>::get()
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::get()
     {
         return values.template get<I>();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<size_t I>
-    auto ComponentSoA<C, nodeCount, Ts...>::get() const
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::get() const
     {
         return values.template get<I>();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<size_t I>
-    auto ComponentSoA<C, nodeCount, Ts...>::get(const EntityType& value)
+    auto& ComponentSoA<C, nodeCount, Allocator, Ts...>::get(const EntityType& value)
     {
+        ticks.touch(sparse[value]);
         return values.template get<I>()[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<size_t I>
-    auto ComponentSoA<C, nodeCount, Ts...>::get(const EntityType& value) const
+    const auto& ComponentSoA<C, nodeCount, Allocator, Ts...>::get(const EntityType& value) const
     {
         return values.template get<I>()[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<size_t I>
-    auto ComponentSoA<C, nodeCount, Ts...>::get(EntityType&& value)
+    auto& ComponentSoA<C, nodeCount, Allocator, Ts...>::get(EntityType&& value)
     {
+        ticks.touch(sparse[value]);
         return values.template get<I>()[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<size_t I>
-    auto ComponentSoA<C, nodeCount, Ts...>::get(EntityType&& value) const
+    const auto& ComponentSoA<C, nodeCount, Allocator, Ts...>::get(EntityType&& value) const
     {
         return values.template get<I>()[sparse[value]];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    auto ComponentSoA<C, nodeCount, Ts...>::operator[](size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::operator[](size_type n)
     {
         return values[n];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename... Ts>
-    auto ComponentSoA<C, nodeCount, Ts...>::operator[](size_type n) const
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    auto ComponentSoA<C, nodeCount, Allocator, Ts...>::operator[](size_type n) const
     {
         return values[n];
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::resize(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::resize(size_type n)
     {
         packed.resize(n);
         sparse.resize(n);
         values.resize(n);
+        ticks.resize(n);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::reserve(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::reserve(size_type n)
     {
         packed.reserve(n);
         sparse.reserve(n);
         values.reserve(n);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::set_capacity(size_type n)
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::set_capacity(size_type n)
     {
         packed.set_capacity(n);
         sparse.set_capacity(n);
         values.set_capacity(n);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::shrink_to_fit()
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::shrink_to_fit()
     {
         packed.shrink_to_fit();
-        sparse.shrink_to_fit();
+        sparse.release_unused(packed.begin(), packed.end());
         values.shrink_to_fit();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline auto ComponentSoA<C, nodeCount, Ts...>::data() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline auto ComponentSoA<C, nodeCount, Allocator, Ts...>::data() noexcept
     {
         return values.mpBegin;
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline auto ComponentSoA<C, nodeCount, Ts...>::data() const noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline auto ComponentSoA<C, nodeCount, Allocator, Ts...>::data() const noexcept
     {
         return values.mpBegin;
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::add(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline typename ComponentSoA<C, nodeCount, Allocator, Ts...>::size_type
+    ComponentSoA<C, nodeCount, Allocator, Ts...>::padded_size() const noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if constexpr (C == ALIGNED)
+            return values.padded_size();
+        else
+            return packed.size();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::add(const EntityType &value) noexcept
+    {
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::add(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::add(EntityType &&value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<typename ...Args>
-    inline void ComponentSoA<C, nodeCount, Ts...>::add(const EntityType &value, Args&&... data) noexcept
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::add(const EntityType &value, Args&&... data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back(data...);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<typename ...Args>
-    inline void ComponentSoA<C, nodeCount, Ts...>::add(EntityType &&value, Args&&... data) noexcept
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::add(EntityType &&value, Args&&... data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back(data...);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline typename ComponentSoA<C, nodeCount, Allocator, Ts...>::size_type
+    ComponentSoA<C, nodeCount, Allocator, Ts...>::add_n(const EntityType* ids, size_type n)
+    {
+        const size_type added = base_type::add_n(ids, n);
+        values.resize(packed.size());
+        CORSAC_ECS_STATS_VALUES_N(stats, values, packed.size() - added, (sizeof(Ts) + ... + 0));
+        ticks.resize(packed.size());
+        return added;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline typename ComponentSoA<C, nodeCount, Allocator, Ts...>::size_type
+    ComponentSoA<C, nodeCount, Allocator, Ts...>::add_n(const EntityType* ids, size_type n, const Ts*... data)
+    {
+        const size_type count = packed.size();
+        const size_type added = base_type::add_n(ids, n);
+        if (added == n)
+        {
+            values.resize(count + n);
+            CORSAC_ECS_STATS_VALUES_N(stats, values, count, (sizeof(Ts) + ... + 0));
+            internal::copy_columns(values, count, n, corsac::index_sequence_for<Ts...>(), data...);
+            ticks.resize(packed.size());
+            return added;
+        }
+        values.reserve(count + added);
+        CORSAC_ECS_STATS_VALUES_N(stats, values, count, (sizeof(Ts) + ... + 0));
+        for (size_type i = 0, j = count; i < n && j < packed.size(); ++i)
+        {
+            if (packed[j] == ids[i])
+            {
+                values.push_back(data[i]...);
+                ++j;
+            }
+        }
+        ticks.resize(packed.size());
+        return added;
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::set(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::set(const EntityType &value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
+            ticks.touch(sparse[value]);
             values.at(sparse[value]) = {};
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::set(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::set(EntityType &&value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
+            ticks.touch(sparse[value]);
             values.at(sparse[value]) = {};
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back();
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<typename ...Args>
-    inline void ComponentSoA<C, nodeCount, Ts...>::set(const EntityType &value, Args&&... data) noexcept
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::set(const EntityType &value, Args&&... data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
+            ticks.touch(sparse[value]);
             values.at(sparse[value]) = {data...};
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(value);
         values.push_back(data...);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<typename ...Args>
-    inline void ComponentSoA<C, nodeCount, Ts...>::set(EntityType &&value, Args&&... data) noexcept
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::set(EntityType &&value, Args&&... data) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
+        {
+            ticks.touch(sparse[value]);
             values.at(sparse[value]) = {data...};
-        sparse[value] = packed.size();
+            return;
+        }
+        sparse.assure(value) = static_cast<EntityType>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
         values.push_back(data...);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        CORSAC_ECS_STATS_VALUES(stats, values, (sizeof(Ts) + ... + 0));
+        ticks.push();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::fit(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::fit(const EntityType &value) noexcept
     {
+        ticks.touch(sparse[value]);
         values.at(sparse[value]) = {};
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::fit(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::fit(EntityType &&value) noexcept
     {
+        ticks.touch(sparse[value]);
         values.at(sparse[value]) = {};
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<typename ...Args>
-    inline void ComponentSoA<C, nodeCount, Ts...>::fit(const EntityType &value, Args&&... data) noexcept
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::fit(const EntityType &value, Args&&... data) noexcept
     {
+        ticks.touch(sparse[value]);
         values.at(sparse[value]) = {data...};
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
     template<typename ...Args>
-    inline void ComponentSoA<C, nodeCount, Ts...>::fit(EntityType &&value, Args&&... data) noexcept
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::fit(EntityType &&value, Args&&... data) noexcept
     {
+        ticks.touch(sparse[value]);
         values.at(sparse[value]) = {data...};
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::remove(const EntityType &value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::remove(const EntityType &value) noexcept
     {
         if (has(value))
         {
+            ticks.erase(sparse[value]);
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(EntityType) + (sizeof(Ts) + ... + 0));
+            entry.reset(value);
             packed[sparse[value]] = packed.back();
             values[sparse[value]] = values.back();
             sparse[packed.back()] = sparse[value];
@@ -939,11 +1455,14 @@ namespace corsac
         }
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::remove(EntityType &&value) noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::remove(EntityType &&value) noexcept
     {
         if (has(value))
         {
+            ticks.erase(sparse[value]);
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(EntityType) + (sizeof(Ts) + ... + 0));
+            entry.reset(value);
             packed[sparse[value]] = packed.back();
             values[sparse[value]] = values.back();
             sparse[packed.back()] = sparse[value];
@@ -952,24 +1471,197 @@ namespace corsac
         }
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::clear() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::swap_at(size_type lhs, size_type rhs) noexcept
     {
+        base_type::swap_at(lhs, rhs);
+        ticks.swap(lhs, rhs);
+        corsac::tuple<Ts...> tmp(values[lhs]);
+        values[lhs] = values[rhs];
+        values[rhs] = tmp;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    template<typename Compare>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::sort(Compare compare)
+    {
+        auto order = internal::sort_order(packed.size(), [this, &compare](size_type lhs, size_type rhs) {
+            return compare(values[lhs], values[rhs]);
+        });
+        internal::permute(*this, order);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    template<typename Key>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::sort_by_key(Key key)
+    {
+        auto order = internal::radix_order(packed.size(), [this, &key](size_type pos) {
+            return corsac::apply(key, values[pos]);
+        });
+        internal::permute(*this, order);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    template<typename Other>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::sort_as(const Other& other)
+    {
+        internal::sort_as(*this, other);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::clear() noexcept
+    {
+        entry.reset(packed.begin(), packed.end());
         packed.clear();
         sparse.clear();
         values.clear();
+        ticks.clear();
     }
 
-    template<ComponentContainerType C, size_t nodeCount, typename ...Ts>
-    inline void ComponentSoA<C, nodeCount, Ts...>::reset_lose_memory() noexcept
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::reset_lose_memory() noexcept
     {
-        packed.reset_lose_memory();
+        base_type::reset_lose_memory();
         values.reset_lose_memory();
+        ticks.reset_lose_memory();
     }
 
-    template<ComponentContainerType C, size_t nodeCount>
-    class ComponentTag : public sparse_set<EntityType, nodeCount, C != STATIC>
-    {};
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline MemoryUsage ComponentSoA<C, nodeCount, Allocator, Ts...>::memory_usage() const noexcept
+    {
+        // Строка значений - по элементу из каждой колонки.
+        constexpr size_t row = (sizeof(Ts) + ... + 0);
+        MemoryUsage usage = base_type::memory_usage();
+        usage.values_used     = static_cast<size_t>(values.size()) * row;
+        usage.values_capacity = static_cast<size_t>(values.capacity()) * row;
+        usage += ticks.memory_usage();
+        return usage;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::snapshot(Snapshot& out) const
+    {
+        static_assert((corsac::is_trivially_copyable<Ts>::value && ...),
+                      "ComponentSoA::snapshot - values must be trivially copyable");
+        constexpr uint32_t stride = static_cast<uint32_t>(sizeof(EntityType) + (sizeof(Ts) + ...));
+        out.write_header(internal::SNAPSHOT_SOA, packed.size(), static_cast<uint32_t>(sizeof...(Ts)), stride);
+        base_type::write_packed(out);
+        internal::write_columns(out, values, packed.size(), corsac::index_sequence_for<Ts...>());
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline bool ComponentSoA<C, nodeCount, Allocator, Ts...>::restore(Snapshot& in)
+    {
+        static_assert((corsac::is_trivially_copyable<Ts>::value && ...),
+                      "ComponentSoA::restore - values must be trivially copyable");
+        constexpr uint32_t stride = static_cast<uint32_t>(sizeof(EntityType) + (sizeof(Ts) + ...));
+        const size_type n = in.read_header(internal::SNAPSHOT_SOA, static_cast<uint32_t>(sizeof...(Ts)), stride);
+        if (n == Snapshot::npos)
+            return false;
+        base_type::read_packed(in, n);
+        values.resize(n);
+        internal::read_columns(in, values, n, corsac::index_sequence_for<Ts...>());
+        ticks.clear();
+        ticks.resize(n);
+        return true;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline bool ComponentSoA<C, nodeCount, Allocator, Ts...>::open(const char* path)
+    {
+        static_assert(C == MAPPED, "ComponentSoA::open -- not mapped");
+        const std::string packedPath = std::string(path) + ".packed";
+        if (!base_type::accepts(packedPath.c_str()) || !Values::accepts(path))
+            return false;
+        // Снимок содержимого в памяти: если файлы отобразятся не все, хранилище возвращается к нему.
+        const corsac::vector<EntityType> previousPacked(packed.begin(), packed.end());
+        Values previousValues(values);
+        const bool opened = base_type::open(packedPath.c_str()) && values.open(path);
+        if (!opened)
+        {
+            base_type::close();
+            values.close();
+            values = corsac::move(previousValues);
+            base_type::assign_packed(previousPacked.data(), previousPacked.size());
+        }
+        while (packed.size() > values.common_size())
+            base_type::remove(EntityType(packed.back()));
+        values.resize(packed.size());
+        ticks.clear();
+        ticks.resize(packed.size());
+        return opened;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::sync() noexcept
+    {
+        static_assert(C == MAPPED, "ComponentSoA::sync -- not mapped");
+        base_type::sync();
+        values.sync();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::track_changes(bool enable)
+    {
+        if (enable)
+            ticks.enable(packed.size());
+        else
+            ticks.disable();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline bool ComponentSoA<C, nodeCount, Allocator, Ts...>::tracking() const noexcept
+    {
+        return ticks.tracking();
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline Tick ComponentSoA<C, nodeCount, Allocator, Ts...>::added_at(const EntityType& value) const noexcept
+    {
+        return has(value) ? ticks.added_at(sparse[value]) : 0;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline Tick ComponentSoA<C, nodeCount, Allocator, Ts...>::changed_at(const EntityType& value) const noexcept
+    {
+        return has(value) ? ticks.changed_at(sparse[value]) : 0;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline bool ComponentSoA<C, nodeCount, Allocator, Ts...>::added_since(const EntityType& value, Tick tick) const noexcept
+    {
+        return !ticks.tracking() || added_at(value) >= tick;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline bool ComponentSoA<C, nodeCount, Allocator, Ts...>::changed_since(const EntityType& value, Tick tick) const noexcept
+    {
+        return !ticks.tracking() || changed_at(value) >= tick;
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator, typename... Ts>
+    inline void ComponentSoA<C, nodeCount, Allocator, Ts...>::touch(const EntityType& value) noexcept
+    {
+        if (has(value))
+            ticks.touch(sparse[value]);
+    }
+
+    template<ComponentContainerType C, size_t nodeCount, typename Allocator = internal::default_allocator>
+    class ComponentTag : public sparse_set<EntityType, nodeCount, C != STATIC, CORSAC_ECS_SPARSE_PAGE_SIZE, C == MAPPED, Allocator>
+    {
+    public:
+        static constexpr internal::ComponentType component_type = internal::TAG;
+
+        using value_tuple = corsac::tuple<>;
+
+        ComponentTag() noexcept
+        {
+            this->entry.enroll(this);
+        }
+    };
+
+    template<typename... Ts>
+    class ComponentArchetype;
 
     template<typename... Ts>
     class SingleComponentSoA
@@ -988,25 +1680,50 @@ namespace corsac
 
     };
 
+    namespace internal
+    {
+        /**
+         * component_refs
+         *
+         * Ссылки на данные хранилища в позиции pos его packed массива:
+         *      AOS         - tuple<T&>
+         *      SOA         - tuple<Ts&...>, по одной ссылке на колонку
+         *      TAG, GROUP  - tuple<>
+         */
+        template<typename Storage, typename size_type>
+        inline auto component_refs(Storage& storage, size_type pos)
+        {
+            if constexpr (Storage::component_type == AOS)
+                return corsac::tuple<decltype(storage.data()[pos])>(storage.data()[pos]);
+            else if constexpr (Storage::component_type == SOA)
+                return storage.values[pos];
+            else
+                return corsac::tuple<>();
+        }
+    }
+
     template<typename... Ts>
-    struct Component : public ComponentSoA<DYNAMIC, 0, Ts...>
+    struct Component : public ComponentSoA<DYNAMIC, 0, internal::default_allocator, Ts...>
     {
-        template<ComponentContainerType C, size_t nodeCount = 0>
-        using Config = corsac::conditional_t<C == SINGLE, SingleComponentSoA<Ts...>, ComponentSoA<C, nodeCount, Ts...>>;
+        template<ComponentContainerType C, size_t nodeCount = 0, typename Allocator = internal::default_allocator>
+        using Config = corsac::conditional_t<C == SINGLE, SingleComponentSoA<Ts...>,
+                      corsac::conditional_t<C == ARCHETYPE, ComponentArchetype<Ts...>, ComponentSoA<C, nodeCount, Allocator, Ts...>>>;
     };
 
     template<typename T>
     struct Component<T> : public ComponentAoS<DYNAMIC, 0, T>
     {
-        template<ComponentContainerType C, size_t nodeCount = 0>
-        using Config = corsac::conditional_t<C == SINGLE, SingleComponentAoS<T>, ComponentAoS<C, nodeCount, T>>;
+        template<ComponentContainerType C, size_t nodeCount = 0, typename Allocator = internal::default_allocator>
+        using Config = corsac::conditional_t<C == SINGLE, SingleComponentAoS<T>,
+                      corsac::conditional_t<C == ARCHETYPE, ComponentArchetype<T>, ComponentAoS<C, nodeCount, T, Allocator>>>;
     };
 
     template<>
     struct Component<> : public ComponentTag<DYNAMIC, 0>
     {
-        template<ComponentContainerType C, size_t nodeCount = 0>
-        using Config = corsac::conditional_t<C == SINGLE, SingleComponentTag, ComponentTag<C, nodeCount>>;
+        template<ComponentContainerType C, size_t nodeCount = 0, typename Allocator = internal::default_allocator>
+        using Config = corsac::conditional_t<C == SINGLE, SingleComponentTag,
+                      corsac::conditional_t<C == ARCHETYPE, ComponentArchetype<>, ComponentTag<C, nodeCount, Allocator>>>;
     };
 }
 
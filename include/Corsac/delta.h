@@ -0,0 +1,432 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_DELTA_H
+#define CORSAC_ECS_DELTA_H
+
+#include "Corsac/component.h"
+#include "Corsac/group.h"
+#include "Corsac/snapshot.h"
+#include "Corsac/tuple.h"
+#include "Corsac/vector.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace corsac
+{
+    namespace internal
+    {
+        /**
+         * delta_baseline
+         *
+         * Состояние хранилища на момент прошлой дельты: ID и копии значений в порядке packed.
+         * Вне реестра сигнатур, обновляется вместе с записью дельты только по изменениям.
+         */
+        template<typename Tuple>
+        struct delta_baseline;
+
+        template<typename... Ts>
+        struct delta_baseline<corsac::tuple<Ts...>>
+        {
+            using row_type = corsac::tuple<Ts...>;
+
+            sparse_set<EntityType>    ids;
+            corsac::vector<row_type>  rows;
+
+            void add(const EntityType& value, const row_type& row)
+            {
+                ids.add(value);
+                if constexpr (sizeof...(Ts) != 0)
+                    rows.push_back(row);
+            }
+
+            // Перенос последней строки, как в sparse_set::remove.
+            void remove(const EntityType& value)
+            {
+                if constexpr (sizeof...(Ts) != 0)
+                {
+                    rows[ids.index(value)] = rows.back();
+                    rows.pop_back();
+                }
+                ids.remove(value);
+            }
+
+            void clear() noexcept
+            {
+                ids.clear();
+                rows.clear();
+            }
+        };
+
+        template<typename Storage>
+        using delta_baseline_t = delta_baseline<typename Storage::value_tuple>;
+
+        // Поле I значения сущности: AOS хранит одно поле, SOA - колонку на поле.
+        template<size_t I, typename Storage>
+        inline decltype(auto) delta_field(Storage& storage, const EntityType& value)
+        {
+            if constexpr (corsac::decay_t<Storage>::component_type == AOS)
+                return storage.get(value);
+            else
+                return storage.template get<I>(value);
+        }
+
+        template<typename Storage, size_t... I>
+        inline auto delta_row(const Storage& storage, const EntityType& value, corsac::index_sequence<I...>)
+        {
+            return typename Storage::value_tuple(delta_field<I>(storage, value)...);
+        }
+
+        /**
+         * write_xor, read_xor
+         *
+         * Поле пишется XOR с базой: поля в 1, 2, 4 и 8 байт - целым переменной длины,
+         * поэтому мелкие изменения и нули занимают байт, остальные - сырыми байтами.
+         * read_xor накладывает XOR на value, которое до вызова содержит базу.
+         */
+        template<typename F>
+        inline void write_xor(Snapshot& out, const F& value, const F& base)
+        {
+            static_assert(corsac::is_trivially_copyable<F>::value, "DeltaEncoder - values must be trivially copyable");
+            if constexpr (sizeof(F) == 1 || sizeof(F) == 2 || sizeof(F) == 4 || sizeof(F) == 8)
+            {
+                uint64_t lhs = 0, rhs = 0;
+                std::memcpy(&lhs, &value, sizeof(F));
+                std::memcpy(&rhs, &base, sizeof(F));
+                out.write_varint(lhs ^ rhs);
+            }
+            else
+            {
+                uint8_t bytes[sizeof(F)];
+                const auto* lhs = reinterpret_cast<const uint8_t*>(&value);
+                const auto* rhs = reinterpret_cast<const uint8_t*>(&base);
+                for (size_t i = 0; i < sizeof(F); ++i)
+                    bytes[i] = static_cast<uint8_t>(lhs[i] ^ rhs[i]);
+                out.write(bytes, sizeof(F));
+            }
+        }
+
+        template<typename F>
+        inline bool read_xor(Snapshot& in, F& value) noexcept
+        {
+            uint8_t bytes[sizeof(F)] = {};
+            if constexpr (sizeof(F) == 1 || sizeof(F) == 2 || sizeof(F) == 4 || sizeof(F) == 8)
+            {
+                uint64_t x = 0;
+                if (!in.read_varint(x))
+                    return false;
+                std::memcpy(bytes, &x, sizeof(F));
+            }
+            else if (!in.read_checked(bytes, sizeof(F)))
+                return false;
+            auto* target = reinterpret_cast<uint8_t*>(&value);
+            for (size_t i = 0; i < sizeof(F); ++i)
+                target[i] = static_cast<uint8_t>(target[i] ^ bytes[i]);
+            return true;
+        }
+
+        // Вид секции, кол-во полей и их суммарный размер: дельта читается хранилищем той же раскладки.
+        template<typename Storage>
+        inline void write_section(Snapshot& out, SnapshotBlock kind)
+        {
+            using row_type = typename Storage::value_tuple;
+            out.write_varint(kind);
+            out.write_varint(corsac::tuple_size<row_type>::value);
+            out.write_varint(sizeof(row_type));
+        }
+
+        template<typename Storage>
+        inline bool read_section(Snapshot& in, SnapshotBlock kind)
+        {
+            using row_type = typename Storage::value_tuple;
+            uint64_t k = 0, columns = 0, stride = 0;
+            return in.read_varint(k) && in.read_varint(columns) && in.read_varint(stride)
+                   && k == kind && columns == corsac::tuple_size<row_type>::value && stride == sizeof(row_type);
+        }
+
+        // Возрастающие ID разностями соседних.
+        inline void write_ids(Snapshot& out, corsac::vector<EntityType>& ids)
+        {
+            std::sort(ids.begin(), ids.end());
+            out.write_varint(ids.size());
+            EntityType prev = 0;
+            for (const EntityType& value : ids)
+            {
+                out.write_varint(value - prev);
+                prev = value;
+            }
+        }
+
+        inline bool read_ids(Snapshot& in, corsac::vector<EntityType>& ids)
+        {
+            uint64_t n = 0;
+            // Каждый ID занимает хотя бы байт.
+            if (!in.read_varint(n) || n > in.remaining())
+                return false;
+            ids.resize(static_cast<size_t>(n));
+            uint64_t value = 0;
+            for (EntityType& id : ids)
+            {
+                uint64_t step = 0;
+                if (!in.read_varint(step))
+                    return false;
+                value += step;
+                id = static_cast<EntityType>(value);
+            }
+            return true;
+        }
+
+        // Колонка I новых сущностей, каждое значение - XOR с предыдущим в колонке.
+        template<size_t I, typename Storage>
+        inline void write_added_column(Snapshot& out, const Storage& storage, const corsac::vector<EntityType>& ids)
+        {
+            using field_type = corsac::tuple_element_t<I, typename Storage::value_tuple>;
+            field_type prev;
+            std::memset(&prev, 0, sizeof(prev));
+            for (const EntityType& value : ids)
+            {
+                const field_type& field = delta_field<I>(storage, value);
+                write_xor(out, field, prev);
+                prev = field;
+            }
+        }
+
+        template<size_t I, typename Row>
+        inline bool read_added_column(Snapshot& in, corsac::vector<Row>& rows)
+        {
+            using field_type = corsac::tuple_element_t<I, Row>;
+            field_type prev;
+            std::memset(&prev, 0, sizeof(prev));
+            for (Row& row : rows)
+            {
+                field_type& field = corsac::get<I>(row);
+                field = prev;
+                if (!read_xor(in, field))
+                    return false;
+                prev = field;
+            }
+            return true;
+        }
+
+        template<size_t I, typename Storage, typename Baseline>
+        inline void write_modified_column(Snapshot& out, const Storage& storage, const Baseline& baseline,
+                                          const corsac::vector<EntityType>& ids)
+        {
+            for (const EntityType& value : ids)
+                write_xor(out, delta_field<I>(storage, value), corsac::get<I>(baseline.rows[baseline.ids.index(value)]));
+        }
+
+        // Сущности, которых нет у получателя, читаются вхолостую.
+        template<size_t I, typename Storage>
+        inline bool read_modified_column(Snapshot& in, Storage& storage, const corsac::vector<EntityType>& ids)
+        {
+            using field_type = corsac::tuple_element_t<I, typename Storage::value_tuple>;
+            for (const EntityType& value : ids)
+            {
+                field_type scratch;
+                std::memset(&scratch, 0, sizeof(scratch));
+                const bool ok = storage.has(value)
+                        ? read_xor(in, delta_field<I>(storage, value))
+                        : read_xor(in, scratch);
+                if (!ok)
+                    return false;
+            }
+            return true;
+        }
+
+        template<typename Storage, typename Row, size_t... I>
+        inline void delta_add(Storage& storage, const EntityType& value, const Row& row, corsac::index_sequence<I...>)
+        {
+            if constexpr (Storage::component_type == AOS || Storage::component_type == SOA)
+                storage.set(value, corsac::get<I>(row)...);
+            else
+                storage.add(value);
+        }
+
+        template<typename Storage, typename Baseline>
+        inline void encode_removed(Snapshot& out, const Storage& storage, Baseline& baseline)
+        {
+            corsac::vector<EntityType> removed;
+            for (const EntityType& value : baseline.ids)
+            {
+                if (!storage.has(value))
+                    removed.push_back(value);
+            }
+            write_section<Storage>(out, SNAPSHOT_DELTA_REMOVED);
+            write_ids(out, removed);
+            for (const EntityType& value : removed)
+                baseline.remove(value);
+        }
+
+        template<typename Storage>
+        inline bool apply_removed(Snapshot& in, Storage& storage)
+        {
+            corsac::vector<EntityType> removed;
+            if (!read_section<Storage>(in, SNAPSHOT_DELTA_REMOVED) || !read_ids(in, removed))
+                return false;
+            for (const EntityType& value : removed)
+                storage.remove(value);
+            return true;
+        }
+
+        template<typename Storage, typename Baseline, size_t... I>
+        inline void encode_changes(Snapshot& out, const Storage& storage, Baseline& baseline, Tick since,
+                                   corsac::index_sequence<I...> columns)
+        {
+            corsac::vector<EntityType> added;
+            corsac::vector<EntityType> modified;
+            const EntityType* entities = storage.entities();
+            for (size_t pos = 0; pos < storage.size(); ++pos)
+            {
+                const EntityType& value = entities[pos];
+                if (!baseline.ids.has(value))
+                    added.push_back(value);
+                else if constexpr (sizeof...(I) != 0)
+                {
+                    // С учетом изменений значения, не менявшиеся с прошлой дельты, не сравниваются.
+                    if (!storage.changed_since(value, since))
+                        continue;
+                    const auto& row = baseline.rows[baseline.ids.index(value)];
+                    const bool changed = ((std::memcmp(&delta_field<I>(storage, value), &corsac::get<I>(row),
+                                                       sizeof(corsac::get<I>(row))) != 0) || ...);
+                    if (changed)
+                        modified.push_back(value);
+                }
+            }
+
+            write_section<Storage>(out, SNAPSHOT_DELTA_CHANGES);
+            write_ids(out, added);
+            (write_added_column<I>(out, storage, added), ...);
+            for (const EntityType& value : added)
+                baseline.add(value, delta_row(storage, value, columns));
+
+            write_ids(out, modified);
+            (write_modified_column<I>(out, storage, baseline, modified), ...);
+            for (const EntityType& value : modified)
+                baseline.rows[baseline.ids.index(value)] = delta_row(storage, value, columns);
+        }
+
+        template<typename Storage, size_t... I>
+        inline bool apply_changes(Snapshot& in, Storage& storage, corsac::index_sequence<I...> columns)
+        {
+            using row_type = typename Storage::value_tuple;
+
+            corsac::vector<EntityType> ids;
+            if (!read_section<Storage>(in, SNAPSHOT_DELTA_CHANGES) || !read_ids(in, ids))
+                return false;
+            corsac::vector<row_type> rows(sizeof...(I) != 0 ? ids.size() : 0);
+            if (!(read_added_column<I>(in, rows) && ...))
+                return false;
+            for (size_t i = 0; i < ids.size(); ++i)
+                delta_add(storage, ids[i], sizeof...(I) != 0 ? rows[i] : row_type(), columns);
+
+            if (!read_ids(in, ids))
+                return false;
+            return (read_modified_column<I>(in, storage, ids) && ...);
+        }
+    }
+
+    /**
+     * DeltaEncoder
+     *
+     * Дельта аллокатора сущностей и хранилищ Storages относительно прошлого encode():
+     * удаленные, добавленные (со значениями) и измененные сущности. ID пишутся возрастающими
+     * разностями переменной длины, значения - по колонкам, XOR с базой. Первый encode()
+     * и encode() после reset() отдают все содержимое как добавленное.
+     *
+     * corsac::DeltaEncoder<Position, Health, Unit> encoder;
+     * corsac::Snapshot delta;
+     * encoder.encode(delta);
+     * ...
+     * corsac::apply_delta<Position, Health, Unit>(delta);
+     *
+     * Группы перечисляются после своих компонентов, как в snapshot(): удаления применяются
+     * в обратном порядке, поэтому группы отпускают сущности раньше компонентов, а добавления -
+     * в прямом. Без учета изменений (track_changes) encode() сравнивает значения всех
+     * сущностей, с ним - только измененных после прошлой дельты.
+     */
+    template<auto&... Storages>
+    class DeltaEncoder
+    {
+        static_assert(((corsac::decay_t<decltype(Storages)>::component_type != internal::CHUNK) && ...),
+                      "DeltaEncoder - ARCHETYPE components are not supported");
+
+        using baseline_tuple = corsac::tuple<internal::delta_baseline_t<corsac::decay_t<decltype(Storages)>>...>;
+        using index_sequence = corsac::index_sequence_for<decltype(Storages)...>;
+
+    protected:
+        EntityAllocator<EntityType> allocator;
+        baseline_tuple              baselines;
+        Tick                        since = 0;
+
+    public:
+        DeltaEncoder() = default;
+
+        void encode(Snapshot& out);
+
+        // Следующий encode() отдаст полное состояние.
+        void reset() noexcept;
+
+    private:
+        template<size_t... I>
+        void encode(Snapshot& out, corsac::index_sequence<I...>);
+    };
+
+    template<auto&... Storages>
+    inline void DeltaEncoder<Storages...>::encode(Snapshot& out)
+    {
+        encode(out, index_sequence());
+    }
+
+    template<auto&... Storages>
+    template<size_t... I>
+    inline void DeltaEncoder<Storages...>::encode(Snapshot& out, corsac::index_sequence<I...>)
+    {
+        constexpr size_t count = sizeof...(Storages);
+        const auto storages = corsac::make_tuple(&Storages...);
+
+        out.write_header(internal::SNAPSHOT_DELTA, 0, static_cast<uint32_t>(count), 0);
+        internal::getEntityAllocator().delta(out, allocator);
+        (internal::encode_removed(out, *corsac::get<count - 1 - I>(storages), corsac::get<count - 1 - I>(baselines)), ...);
+        (internal::encode_changes(out, Storages, corsac::get<I>(baselines), since,
+                                  corsac::make_index_sequence<corsac::tuple_size<
+                                          typename corsac::decay_t<decltype(Storages)>::value_tuple>::value>()), ...);
+        since = current_tick();
+    }
+
+    template<auto&... Storages>
+    inline void DeltaEncoder<Storages...>::reset() noexcept
+    {
+        allocator.clear();
+        corsac::apply([](auto&... baseline) { (baseline.clear(), ...); }, baselines);
+        since = 0;
+    }
+
+    namespace internal
+    {
+        template<auto&... Storages, size_t... I>
+        inline bool apply_delta(Snapshot& in, corsac::index_sequence<I...>)
+        {
+            constexpr size_t count = sizeof...(Storages);
+            const auto storages = corsac::make_tuple(&Storages...);
+
+            return (apply_removed(in, *corsac::get<count - 1 - I>(storages)) && ...)
+                   && (apply_changes(in, Storages, corsac::make_index_sequence<corsac::tuple_size<
+                               typename corsac::decay_t<decltype(Storages)>::value_tuple>::value>()) && ...);
+        }
+    }
+
+    // Применяет дельту DeltaEncoder с тем же списком хранилищ, false - дельта не подходит или обрезана.
+    template<auto&... Storages>
+    inline bool apply_delta(Snapshot& in)
+    {
+        if (in.read_header(internal::SNAPSHOT_DELTA, static_cast<uint32_t>(sizeof...(Storages)), 0) == Snapshot::npos)
+            return false;
+        return internal::getEntityAllocator().apply_delta(in)
+               && internal::apply_delta<Storages...>(in, corsac::index_sequence_for<decltype(Storages)...>());
+    }
+}
+
+#endif //CORSAC_ECS_DELTA_H
@@ -5,8 +5,22 @@
 #ifndef CORSAC_ECS_ECS_H
 #define CORSAC_ECS_ECS_H
 
+#include "Corsac/registry.h"
+#include "Corsac/stats.h"
+#include "Corsac/memory.h"
+#include "Corsac/snapshot.h"
 #include "Corsac/component.h"
 #include "Corsac/group.h"
+#include "Corsac/view.h"
+#include "Corsac/system.h"
+#include "Corsac/scheduler.h"
+#include "Corsac/observer.h"
+#include "Corsac/command_buffer.h"
+#include "Corsac/simd.h"
+#include "Corsac/archetype.h"
+#include "Corsac/delta.h"
+#include "Corsac/world.h"
+#include "Corsac/runtime.h"
 
 namespace corsac
 {
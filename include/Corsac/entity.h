@@ -0,0 +1,328 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_ENTITY_H
+#define CORSAC_ECS_ENTITY_H
+
+#include "Corsac/algorithm.h"
+#include "Corsac/type_traits.h"
+#include "Corsac/vector.h"
+#include "Corsac/snapshot.h"
+#include "Corsac/memory.h"
+
+namespace corsac
+{
+    using EntityType = uint32_t;
+
+    /**
+     * entity_traits
+     *
+     * Раскладка идентификатора сущности:
+     *      index   - младшие 3/4 бит, адресует разреженные массивы.
+     *      version - старшая 1/4 бит, поколение ID. Растет при каждом удалении сущности,
+     *                поэтому устаревший ID не совпадает с переиспользованным.
+     */
+    template<typename T>
+    struct entity_traits
+    {
+        static_assert(corsac::is_unsigned_v<T>, "entity_traits can only describe unsigned integers");
+
+        static constexpr size_t version_bits    = sizeof(T) * 2;
+        static constexpr size_t index_bits      = sizeof(T) * 8 - version_bits;
+
+        static constexpr T index_mask           = static_cast<T>(~T(0)) >> version_bits;
+        static constexpr T version_mask         = static_cast<T>(~T(0)) >> index_bits;
+
+        // Индекс index_mask никогда не выдается и служит концом списка свободных ID.
+        static constexpr T null                 = index_mask;
+
+        static constexpr T index(const T& value) noexcept
+        {
+            return static_cast<T>(value & index_mask);
+        }
+
+        static constexpr T version(const T& value) noexcept
+        {
+            return static_cast<T>(value >> index_bits);
+        }
+
+        static constexpr T combine(const T& index, const T& version) noexcept
+        {
+            return static_cast<T>((index & index_mask) | static_cast<T>((version & version_mask) << index_bits));
+        }
+    };
+
+    /**
+     * EntityRange
+     *
+     * Непрерывный блок ID [first, first + size()), выданный EntityAllocator::create_n.
+     * Все ID блока имеют нулевую версию, поэтому идут подряд.
+     */
+    class EntityRange
+    {
+    public:
+        using size_type = size_t;
+
+        class iterator
+        {
+            EntityType value;
+
+        public:
+            explicit iterator(EntityType v) noexcept : value(v) {}
+
+            EntityType operator*() const noexcept { return value; }
+            iterator&  operator++() noexcept { ++value; return *this; }
+
+            bool operator==(const iterator& x) const noexcept { return value == x.value; }
+            bool operator!=(const iterator& x) const noexcept { return value != x.value; }
+        };
+
+    protected:
+        EntityType first;
+        size_type  count;
+
+    public:
+        EntityRange(EntityType f, size_type n) noexcept : first(f), count(n) {}
+
+        iterator begin() const noexcept { return iterator(first); }
+        iterator end() const noexcept { return iterator(static_cast<EntityType>(first + count)); }
+
+        EntityType operator[](size_type n) const noexcept { return static_cast<EntityType>(first + n); }
+
+        [[nodiscard]] bool      empty() const noexcept { return count == 0; }
+        [[nodiscard]] size_type size() const noexcept { return count; }
+    };
+
+    /**
+     * EntityAllocator
+     *
+     * Выдает ID сущностей и переиспользует удаленные через неявный список свободных индексов:
+     * свободный слот entities хранит индекс следующего свободного слота и версию, которую получит
+     * сущность при следующей выдаче. Живой слот хранит сам ID.
+     */
+    template<typename T = EntityType>
+    class EntityAllocator
+    {
+        using traits_type = entity_traits<T>;
+        using base_type   = corsac::vector<T>;
+
+    public:
+        using size_type   = typename base_type::size_type;
+        using value_type  = T;
+
+    protected:
+        base_type entities;
+        T         freeList = traits_type::null;
+        size_type count    = 0;
+
+    public:
+        EntityAllocator() noexcept = default;
+
+        value_type create();
+        void       destroy(const value_type& value) noexcept;
+
+        // Выдает n новых индексов подряд в обход списка свободных, возвращает первый ID.
+        value_type create_n(size_type n);
+
+        [[nodiscard]] bool valid(const value_type& value) const noexcept;
+
+        [[nodiscard]] size_type size() const noexcept;
+        [[nodiscard]] size_type alive() const noexcept;
+
+        void reserve(size_type n);
+        void clear() noexcept;
+
+        // Слоты entities в other, entities - живые, max_id - все выданные индексы.
+        [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+
+        // Слоты, список свободных и кол-во живых одним блоком, restore заменяет состояние целиком.
+        void snapshot(Snapshot& out) const;
+        bool restore(Snapshot& in);
+
+        // Измененные относительно baseline слоты, baseline догоняет текущее состояние.
+        void delta(Snapshot& out, EntityAllocator& baseline) const;
+        bool apply_delta(Snapshot& in);
+    };
+
+    template<typename T>
+    inline typename EntityAllocator<T>::value_type EntityAllocator<T>::create()
+    {
+        ++count;
+        if (freeList != traits_type::null)
+        {
+            const T index = freeList;
+            freeList = traits_type::index(entities[index]);
+            entities[index] = traits_type::combine(index, traits_type::version(entities[index]));
+            return entities[index];
+        }
+    #if CORSAC_EXCEPTIONS_ENABLED
+        if(CORSAC_UNLIKELY(entities.size() >= traits_type::null))
+            throw std::out_of_range("EntityAllocator::create -- out of entity indices");
+    #elif CORSAC_ASSERT_ENABLED
+        if(CORSAC_UNLIKELY(entities.size() >= traits_type::null))
+            CORSAC_FAIL_MSG("EntityAllocator::create -- out of entity indices");
+    #endif
+        const T value = traits_type::combine(static_cast<T>(entities.size()), 0);
+        entities.push_back(value);
+        return value;
+    }
+
+    template<typename T>
+    inline typename EntityAllocator<T>::value_type EntityAllocator<T>::create_n(size_type n)
+    {
+        const size_type first = entities.size();
+    #if CORSAC_EXCEPTIONS_ENABLED
+        if(CORSAC_UNLIKELY(n > traits_type::null - first))
+            throw std::out_of_range("EntityAllocator::create_n -- out of entity indices");
+    #elif CORSAC_ASSERT_ENABLED
+        if(CORSAC_UNLIKELY(n > traits_type::null - first))
+            CORSAC_FAIL_MSG("EntityAllocator::create_n -- out of entity indices");
+    #endif
+        entities.resize(first + n);
+        for (size_type i = first; i < first + n; ++i)
+            entities[i] = traits_type::combine(static_cast<T>(i), 0);
+        count += n;
+        return traits_type::combine(static_cast<T>(first), 0);
+    }
+
+    template<typename T>
+    inline void EntityAllocator<T>::destroy(const value_type& value) noexcept
+    {
+        if (!valid(value))
+            return;
+        const T index = traits_type::index(value);
+        entities[index] = traits_type::combine(freeList, static_cast<T>(traits_type::version(value) + 1));
+        freeList = index;
+        --count;
+    }
+
+    template<typename T>
+    inline bool EntityAllocator<T>::valid(const value_type& value) const noexcept
+    {
+        const T index = traits_type::index(value);
+        return index < entities.size() && entities[index] == value;
+    }
+
+    template<typename T>
+    inline typename EntityAllocator<T>::size_type EntityAllocator<T>::size() const noexcept
+    {
+        return entities.size();
+    }
+
+    template<typename T>
+    inline typename EntityAllocator<T>::size_type EntityAllocator<T>::alive() const noexcept
+    {
+        return count;
+    }
+
+    template<typename T>
+    inline void EntityAllocator<T>::reserve(size_type n)
+    {
+        entities.reserve(n);
+    }
+
+    template<typename T>
+    inline void EntityAllocator<T>::clear() noexcept
+    {
+        entities.clear();
+        freeList = traits_type::null;
+        count = 0;
+    }
+
+    template<typename T>
+    inline MemoryUsage EntityAllocator<T>::memory_usage() const noexcept
+    {
+        MemoryUsage usage;
+        usage.other_used     = entities.size() * sizeof(T);
+        usage.other_capacity = entities.capacity() * sizeof(T);
+        usage.entities       = count;
+        usage.max_id         = entities.size();
+        return usage;
+    }
+
+    template<typename T>
+    inline void EntityAllocator<T>::snapshot(Snapshot& out) const
+    {
+        const uint64_t alive = count;
+        out.write_header(internal::SNAPSHOT_ALLOCATOR, entities.size(), 1, static_cast<uint32_t>(sizeof(T)));
+        out.write(entities.data(), entities.size() * sizeof(T));
+        out.write(&freeList, sizeof(freeList));
+        out.write(&alive, sizeof(alive));
+    }
+
+    template<typename T>
+    inline bool EntityAllocator<T>::restore(Snapshot& in)
+    {
+        const size_type n = in.read_header(internal::SNAPSHOT_ALLOCATOR, 1, static_cast<uint32_t>(sizeof(T)), sizeof(T) + sizeof(uint64_t));
+        if (n == Snapshot::npos)
+            return false;
+        uint64_t alive = 0;
+        entities.resize(n);
+        in.read(entities.data(), n * sizeof(T));
+        in.read(&freeList, sizeof(freeList));
+        in.read(&alive, sizeof(alive));
+        count = static_cast<size_type>(alive);
+        return true;
+    }
+
+    template<typename T>
+    inline void EntityAllocator<T>::delta(Snapshot& out, EntityAllocator& baseline) const
+    {
+        const size_type common = corsac::min(entities.size(), baseline.entities.size());
+        size_type changed = 0;
+        for (size_type i = 0; i < common; ++i)
+            changed += entities[i] != baseline.entities[i];
+
+        out.write_varint(internal::SNAPSHOT_DELTA_ALLOCATOR);
+        out.write_varint(entities.size());
+        out.write_varint(freeList);
+        out.write_varint(count);
+        out.write_varint(changed);
+        // Слоты: разность индексов и XOR с прежним значением, новый хвост - как есть.
+        for (size_type i = 0, prev = 0; i < common; ++i)
+        {
+            if (entities[i] == baseline.entities[i])
+                continue;
+            out.write_varint(i - prev);
+            out.write_varint(entities[i] ^ baseline.entities[i]);
+            prev = i;
+        }
+        for (size_type i = common; i < entities.size(); ++i)
+            out.write_varint(entities[i]);
+        baseline.entities = entities;
+        baseline.freeList = freeList;
+        baseline.count = count;
+    }
+
+    template<typename T>
+    inline bool EntityAllocator<T>::apply_delta(Snapshot& in)
+    {
+        uint64_t kind = 0, size = 0, free = 0, alive = 0, changed = 0;
+        if (!in.read_varint(kind) || kind != internal::SNAPSHOT_DELTA_ALLOCATOR
+            || !in.read_varint(size) || !in.read_varint(free) || !in.read_varint(alive)
+            || !in.read_varint(changed) || size > in.remaining() + entities.size())
+            return false;
+        const size_type common = corsac::min(entities.size(), static_cast<size_type>(size));
+        for (uint64_t i = 0, index = 0, x = 0; i < changed; ++i)
+        {
+            uint64_t step = 0;
+            if (!in.read_varint(step) || !in.read_varint(x) || (index += step) >= common)
+                return false;
+            entities[index] = static_cast<T>(entities[index] ^ x);
+        }
+        entities.resize(static_cast<size_type>(size));
+        for (size_type i = common; i < entities.size(); ++i)
+        {
+            uint64_t value = 0;
+            if (!in.read_varint(value))
+                return false;
+            entities[i] = static_cast<T>(value);
+        }
+        freeList = static_cast<T>(free);
+        count = static_cast<size_type>(alive);
+        return true;
+    }
+}
+
+#endif //CORSAC_ECS_ENTITY_H
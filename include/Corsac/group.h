@@ -11,10 +11,15 @@ namespace corsac
 {
     namespace internal
     {
-        inline EntityType getNewEntityTypeID() noexcept
+        inline EntityAllocator<EntityType>& getEntityAllocator() noexcept
         {
-            static EntityType lastID = 1;
-            return lastID++;
+            static EntityAllocator<EntityType> allocator;
+            return allocator;
+        }
+
+        inline EntityType getNewEntityTypeID()
+        {
+            return getEntityAllocator().create();
         }
 
         template <class F, class... Args>
@@ -22,6 +27,52 @@ namespace corsac
         {
             (f(corsac::forward<Args>(args)), ...);
         }
+
+        // Бит хранилища в реестре сигнатур, у ARCHETYPE компонентов своя сигнатура.
+        template<typename Storage>
+        inline size_t signature_bit(const Storage& storage) noexcept
+        {
+            if constexpr (Storage::component_type == CHUNK)
+                return registry_npos;
+            else
+                return storage.signature_bit();
+        }
+
+        // Адрес хранилища для графа конфликтов Scheduler, у группы - и адреса ее участников.
+        template<typename Storage>
+        inline void conflict_storages(const Storage& storage, corsac::vector<const void*>& out)
+        {
+            out.push_back(&storage);
+            if constexpr (Storage::component_type == GROUP)
+                Storage::member_storages(out);
+        }
+
+        /**
+         * member_refs
+         *
+         * Ссылки на колонки участника группы для сущности value.
+         * Вложенная группа раскрывается в колонки своих участников.
+         */
+        template<typename Storage>
+        inline auto member_refs(Storage& storage, const EntityType& value)
+        {
+            if constexpr (Storage::component_type == GROUP)
+                return storage.get(value);
+            else if constexpr (Storage::component_type == TAG)
+                return corsac::tuple<>();
+            else
+                return component_refs(storage, storage.index(value));
+        }
+
+        // То же для позиции pos владеющей группы, в которой участник выровнен с группой.
+        template<typename Storage, typename size_type>
+        inline auto member_refs_at(Storage& storage, const EntityType& value, size_type pos)
+        {
+            if constexpr (Storage::component_type == GROUP)
+                return storage.get(value);
+            else
+                return component_refs(storage, pos);
+        }
     }
 
     template<auto& ...Group>
@@ -33,9 +84,15 @@ namespace corsac
 
         explicit Entity(EntityType id);
 
+        // Создает n сущностей блоком ID подряд, каждая группа растет один раз.
+        static EntityRange create_n(size_t n);
+
         EntityType id();
 
-        template<auto& Component>
+        bool valid();
+
+        // Несколько компонентов проверяются одним сравнением сигнатуры в реестре.
+        template<auto& ...Components>
         bool has();
 
         template<auto& Component, size_t I>
@@ -84,6 +141,24 @@ namespace corsac
     template<auto &...Group>
     Entity<Group...>::Entity(EntityType id) : ID(id) {};
 
+    template<auto &...Group>
+    inline EntityRange Entity<Group...>::create_n(size_t n)
+    {
+        const EntityRange range(internal::getEntityAllocator().create_n(n), n);
+        if constexpr (sizeof...(Group) > 0)
+        {
+            corsac::vector<EntityType> ids;
+            ids.reserve(n);
+            for (EntityType value : range)
+                ids.push_back(value);
+            corsac::internal::static_for([&ids](auto& G)
+            {
+                G.add_n(ids.data(), ids.size());
+            }, Group...);
+        }
+        return range;
+    }
+
     template<auto &...Group>
     EntityType Entity<Group...>::id()
     {
@@ -91,17 +166,35 @@ namespace corsac
     }
 
     template<auto &...Group>
-    template<auto &Component>
+    inline bool Entity<Group...>::valid()
+    {
+        return internal::getEntityAllocator().valid(ID);
+    }
+
+    template<auto &...Group>
+    template<auto &...Components>
     inline bool Entity<Group...>::has()
     {
-        return Component.has(ID);
+        if constexpr (sizeof...(Components) == 1)
+            return (Components.has(ID) && ...);
+        else
+        {
+            internal::signature mask;
+            bool registered = true;
+            ((internal::signature_bit(Components) != internal::registry_npos
+                    ? mask.set(internal::signature_bit(Components))
+                    : void(registered = false)), ...);
+            if (!registered)
+                return (Components.has(ID) && ...);
+            return internal::getRegistry().has(ID, mask);
+        }
     }
 
     template<auto &...Group>
     template<auto &Component, size_t I>
     inline decltype(auto) Entity<Group...>::get()
     {
-        return Component.get<I>(ID);
+        return Component.template get<I>(ID);
     }
 
     template<auto &...Group>
@@ -177,41 +270,175 @@ namespace corsac
     template<auto &...Group>
     inline void Entity<Group...>::destroy()
     {
+        // Реестр знает все хранилища сущности, Group - только незарегистрированные.
+        internal::getRegistry().destroy(ID);
         corsac::internal::static_for([this](auto& G)
         {
             G.remove(ID);
         }, Group...);
+        internal::getEntityAllocator().destroy(ID);
     }
 
-    template<ComponentContainerType C, size_t nodeCount, auto&...Ts>
-    struct ComponentGroup : public sparse_set<EntityType, nodeCount, C != STATIC>
+    /**
+     * snapshot, restore
+     *
+     * Снимок аллокатора сущностей и перечисленных хранилищ (компонентов, тегов, групп) по блоку
+     * на каждое. restore читает блоки в том же порядке и останавливается на первом неподходящем.
+     * Группы восстанавливаются вместе со своими компонентами, тогда владеющие группы
+     * получают тот же общий префикс. Сигналы Observed при restore не отправляются.
+     */
+    template<auto&... Storages>
+    inline void snapshot(Snapshot& out)
     {
-        using base_type = sparse_set<EntityType, nodeCount, C != STATIC>;
+        internal::getEntityAllocator().snapshot(out);
+        (Storages.snapshot(out), ...);
+    }
+
+    template<auto&... Storages>
+    inline bool restore(Snapshot& in)
+    {
+        return internal::getEntityAllocator().restore(in) && (Storages.restore(in) && ...);
+    }
+
+    /**
+     * memory_usage
+     *
+     * Сумма memory_usage() перечисленных хранилищ, аллокатора сущностей и общего реестра.
+     * Группа отчитывается только своим индексом, ее компоненты перечисляются отдельно.
+     * entities и max_id берутся у аллокатора: density() - доля живых среди выданных ID.
+     */
+    template<auto&... Storages>
+    inline MemoryUsage memory_usage()
+    {
+        const MemoryUsage entities = internal::getEntityAllocator().memory_usage();
+        MemoryUsage usage = internal::getRegistry().memory_usage();
+        ((usage += Storages.memory_usage()), ...);
+        usage += entities;
+        usage.entities = entities.entities;
+        usage.max_id   = entities.max_id;
+        return usage;
+    }
+
+    /**
+     * ComponentGroup
+     *
+     * Набор сущностей, которые одновременно состоят во всех компонентах Ts.
+     * В режиме bOwning группа владеет своими компонентами: ее члены занимают
+     * общий префикс [0, size()) packed/values каждого компонента в том же порядке,
+     * что и packed группы, поэтому обход группы - линейный проход по параллельным массивам.
+     * Компонент может принадлежать только одной владеющей группе, а члены группы
+     * удаляются из компонентов только через группу.
+     */
+    template<ComponentContainerType C, size_t nodeCount, bool bOwning, typename Allocator, auto&...Ts>
+    struct ComponentGroup : public sparse_set<EntityType, nodeCount, C != STATIC, CORSAC_ECS_SPARSE_PAGE_SIZE, false, Allocator>
+    {
+        using base_type = sparse_set<EntityType, nodeCount, C != STATIC, CORSAC_ECS_SPARSE_PAGE_SIZE, false, Allocator>;
+        using size_type = typename base_type::size_type;
 
         using base_type::packed;
         using base_type::sparse;
+        using base_type::entry;
         using base_type::has;
+    #if CORSAC_ECS_STATS
+        using base_type::stats;
+    #endif
+
+        static constexpr internal::ComponentType component_type = internal::GROUP;
+        static constexpr bool owning = bOwning;
+
+        using value_tuple = corsac::tuple<>;
+
+        ComponentGroup() noexcept
+        {
+            // destroy() снимает сущность с группы раньше, чем с ее участников.
+            size_t rank = 0;
+            ((rank = corsac::max(rank, Ts.registry_rank())), ...);
+            entry.enroll(this, rank + 1);
+        }
+
+        // Участники группы для графа конфликтов Scheduler, вложенные группы раскрыты.
+        static void member_storages(corsac::vector<const void*>& out)
+        {
+            (internal::conflict_storages(Ts, out), ...);
+        }
+
+        // Ссылки на колонки всех компонентов группы для сущности value.
+        inline auto get(const EntityType& value) const
+        {
+            return corsac::tuple_cat(internal::member_refs(Ts, value)...);
+        }
+
+        // Ссылки на колонки всех компонентов группы для позиции pos в packed группы.
+        inline auto get_at(size_type pos) const
+        {
+            if constexpr (bOwning)
+                return corsac::tuple_cat(internal::member_refs_at(Ts, packed[pos], pos)...);
+            else
+                return get(packed[pos]);
+        }
 
         inline void add(const EntityType& value) noexcept
         {
-            if (value >= sparse.size())
-                sparse.resize(value * 2);
-            else if (has(value))
+            if (has(value))
                 return;
-            sparse[value] = packed.size();
+            sparse.assure(value) = static_cast<EntityType>(packed.size());
+            entry.set(value);
             packed.push_back(value);
+            CORSAC_ECS_STATS_ADD(stats, sparse, packed);
             corsac::internal::static_for([this, &value](auto& v) {
                 v.add(value);
             }, Ts...);
+            if constexpr (bOwning)
+            {
+                const size_type pos = packed.size() - 1;
+                corsac::internal::static_for([pos, &value](auto& v) {
+                    v.swap_at(v.index(value), pos);
+                }, Ts...);
+            }
+        }
+
+        // Пакетное добавление: участники получают новые сущности одним add_n.
+        inline size_type add_n(const EntityType* ids, size_type n)
+        {
+            const size_type count = packed.size();
+            const size_type added = base_type::add_n(ids, n);
+            corsac::internal::static_for([this, count, added](auto& v) {
+                v.add_n(packed.data() + count, added);
+            }, Ts...);
+            if constexpr (bOwning)
+            {
+                for (size_type pos = count; pos < packed.size(); ++pos)
+                {
+                    corsac::internal::static_for([this, pos](auto& v) {
+                        v.swap_at(v.index(packed[pos]), pos);
+                    }, Ts...);
+                }
+            }
+            return added;
         }
 
         inline void remove(const EntityType& value)
         {
             if (!has(value))
                 return;
-            packed[sparse[value]] = packed.back();
-            sparse[packed.back()] = sparse[value];
-            packed.pop_back();
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(EntityType));
+            if constexpr (bOwning)
+            {
+                const size_type pos = packed.size() - 1;
+                corsac::internal::static_for([pos, &value](auto& v) {
+                    v.swap_at(v.index(value), pos);
+                }, Ts...);
+                entry.reset(value);
+                base_type::swap_at(sparse[value], pos);
+                packed.pop_back();
+            }
+            else
+            {
+                entry.reset(value);
+                packed[sparse[value]] = packed.back();
+                sparse[packed.back()] = sparse[value];
+                packed.pop_back();
+            }
             corsac::internal::static_for([&value](auto& v) {
                 v.remove(value);
             }, Ts...);
@@ -219,10 +446,18 @@ namespace corsac
     };
 
     template<auto&... Ts>
-    struct Group : public ComponentGroup<DYNAMIC, 0, Ts...>
+    struct Group : public ComponentGroup<DYNAMIC, 0, false, internal::default_allocator, Ts...>
+    {
+        template<ComponentContainerType C, size_t nodeCount = 0, bool bOwning = false,
+                 typename Allocator = internal::default_allocator>
+        using Config = ComponentGroup<C, nodeCount, bOwning, Allocator, Ts...>;
+    };
+
+    template<auto&... Ts>
+    struct OwningGroup : public ComponentGroup<DYNAMIC, 0, true, internal::default_allocator, Ts...>
     {
-        template<ComponentContainerType C, size_t nodeCount = 0>
-        using Config = ComponentGroup<C, nodeCount, Ts...>;
+        template<ComponentContainerType C, size_t nodeCount = 0, typename Allocator = internal::default_allocator>
+        using Config = ComponentGroup<C, nodeCount, true, Allocator, Ts...>;
     };
 }
 
@@ -0,0 +1,579 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_MAPPED_VECTOR_H
+#define CORSAC_ECS_MAPPED_VECTOR_H
+
+#include "Corsac/type_traits.h"
+#include "Corsac/algorithm.h"
+#include "Corsac/aligned_vector.h"
+
+#include <cstring>
+#include <new>
+#include <string>
+
+#ifndef CORSAC_ECS_MMAP_ENABLED
+    #if defined(__unix__) || defined(__APPLE__)
+        #define CORSAC_ECS_MMAP_ENABLED 1
+    #else
+        #define CORSAC_ECS_MMAP_ENABLED 0
+    #endif
+#endif
+
+#if CORSAC_ECS_MMAP_ENABLED
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace corsac
+{
+    namespace internal
+    {
+        // Заголовок файла колонки, данные начинаются со смещения mapped_header_size.
+        struct mapped_header
+        {
+            static constexpr uint32_t magic_value = 0x4D534345; // "ECSM"
+
+            uint32_t magic;
+            uint32_t element_size;
+            uint64_t count;
+        };
+
+        static constexpr size_t mapped_header_size = 64;
+
+        /**
+         * mapped_vector
+         *
+         * Колонка хранилища MAPPED в отображенной памяти. До open() память анонимная, после -
+         * общее отображение файла: рост через ftruncate и mremap (Linux) без копирования,
+         * вытеснением занимается страничный кэш ОС. Длина хранится в заголовке файла и
+         * обновляется при каждом изменении, поэтому open() существующего файла сразу отдает
+         * данные без чтения. Значения должны быть тривиально копируемыми.
+         * Без mmap (не POSIX системы) память берется из кучи, а open() возвращает false.
+         */
+        template<typename T>
+        class mapped_vector
+        {
+            static_assert(corsac::is_trivially_copyable<T>::value,
+                          "mapped_vector - values must be trivially copyable");
+            static_assert(alignof(T) <= mapped_header_size,
+                          "mapped_vector - alignment of T exceeds the header size");
+
+        public:
+            using value_type                = T;
+            using size_type                 = size_t;
+            using pointer                   = T*;
+            using const_pointer             = const T*;
+            using reference                 = T&;
+            using const_reference           = const T&;
+            using iterator                  = T*;
+            using const_iterator            = const T*;
+            using reverse_iterator          = corsac::reverse_iterator<iterator>;
+            using const_reverse_iterator    = corsac::reverse_iterator<const_iterator>;
+
+            static constexpr size_type npos = static_cast<size_type>(-1);
+
+            T* mpBegin      = nullptr;
+            T* mpEnd        = nullptr;
+            T* mpCapacity   = nullptr;
+
+        protected:
+            void*     region = nullptr;
+            size_type length = 0;
+            int       fd     = -1;
+
+        public:
+            mapped_vector() noexcept = default;
+            mapped_vector(const mapped_vector& x);
+            mapped_vector(mapped_vector&& x) noexcept;
+            ~mapped_vector();
+
+            mapped_vector& operator=(const mapped_vector& x);
+            mapped_vector& operator=(mapped_vector&& x) noexcept;
+
+            iterator       begin() noexcept { return mpBegin; }
+            const_iterator begin() const noexcept { return mpBegin; }
+            iterator       end() noexcept { return mpEnd; }
+            const_iterator end() const noexcept { return mpEnd; }
+
+            reverse_iterator       rbegin() noexcept { return reverse_iterator(mpEnd); }
+            const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(mpEnd); }
+            reverse_iterator       rend() noexcept { return reverse_iterator(mpBegin); }
+            const_reverse_iterator rend() const noexcept { return const_reverse_iterator(mpBegin); }
+
+            reference       front() { return *mpBegin; }
+            const_reference front() const { return *mpBegin; }
+            reference       back() { return *(mpEnd - 1); }
+            const_reference back() const { return *(mpEnd - 1); }
+
+            reference       operator[](size_type n) { return mpBegin[n]; }
+            const_reference operator[](size_type n) const { return mpBegin[n]; }
+
+            pointer       data() noexcept { return mpBegin; }
+            const_pointer data() const noexcept { return mpBegin; }
+
+            [[nodiscard]] bool      empty() const noexcept { return mpBegin == mpEnd; }
+            [[nodiscard]] size_type size() const noexcept { return static_cast<size_type>(mpEnd - mpBegin); }
+            [[nodiscard]] size_type capacity() const noexcept { return static_cast<size_type>(mpCapacity - mpBegin); }
+            [[nodiscard]] size_type padded_size() const noexcept { return size(); }
+
+            reference push_back();
+            void      push_back(const value_type& value);
+            void      push_back(value_type&& value);
+            void      pop_back() noexcept;
+
+            void resize(size_type n);
+            void resize(size_type n, const value_type& value);
+            void reserve(size_type n);
+            void set_capacity(size_type n = npos);
+            void shrink_to_fit();
+
+            void clear() noexcept;
+            void reset_lose_memory() noexcept;
+
+            // Отображает файл path. Файл этой колонки открывается с его данными, пустой или
+            // новый получает текущее содержимое. Чужой файл не трогается, результат - false.
+            bool open(const char* path);
+
+            // open(path) примет файл: его нет, он пуст или записан колонкой того же типа. Файл не меняется.
+            static bool accepts(const char* path);
+
+            // Переносит данные обратно в анонимную память, файл остается с последним состоянием.
+            void close();
+
+            // Сбрасывает измененные страницы в файл.
+            void sync() noexcept;
+
+            [[nodiscard]] bool is_open() const noexcept { return fd != -1; }
+
+        private:
+            static size_type page_size() noexcept;
+            static size_type bytes_for(size_type n) noexcept;
+            static bool      read_header(int file, size_type fileSize, mapped_header& header) noexcept;
+
+            void grow(size_type n);
+            void remap(size_type n);
+            void store_size() noexcept;
+            void release() noexcept;
+        };
+
+        template<typename T>
+        inline mapped_vector<T>::mapped_vector(const mapped_vector& x)
+        {
+            if (x.capacity() == 0)
+                return;
+            remap(x.capacity());
+            std::memcpy(mpBegin, x.mpBegin, x.size() * sizeof(T));
+            mpEnd = mpBegin + x.size();
+            store_size();
+        }
+
+        template<typename T>
+        inline mapped_vector<T>::mapped_vector(mapped_vector&& x) noexcept
+            : mpBegin(x.mpBegin), mpEnd(x.mpEnd), mpCapacity(x.mpCapacity),
+              region(x.region), length(x.length), fd(x.fd)
+        {
+            x.reset_lose_memory();
+        }
+
+        template<typename T>
+        inline mapped_vector<T>::~mapped_vector()
+        {
+            release();
+        }
+
+        template<typename T>
+        inline mapped_vector<T>& mapped_vector<T>::operator=(const mapped_vector& x)
+        {
+            if (this != &x)
+            {
+                // Открытый файл получает чужое содержимое, а не заменяется анонимной памятью.
+                resize(0);
+                reserve(x.size());
+                if (x.size() != 0)
+                    std::memcpy(mpBegin, x.mpBegin, x.size() * sizeof(T));
+                mpEnd = mpBegin + x.size();
+                store_size();
+            }
+            return *this;
+        }
+
+        template<typename T>
+        inline mapped_vector<T>& mapped_vector<T>::operator=(mapped_vector&& x) noexcept
+        {
+            if (this != &x)
+            {
+                release();
+                mpBegin = x.mpBegin;
+                mpEnd = x.mpEnd;
+                mpCapacity = x.mpCapacity;
+                region = x.region;
+                length = x.length;
+                fd = x.fd;
+                x.reset_lose_memory();
+            }
+            return *this;
+        }
+
+        template<typename T>
+        inline typename mapped_vector<T>::reference mapped_vector<T>::push_back()
+        {
+            if (mpEnd == mpCapacity)
+                grow(size() + 1);
+            ::new(static_cast<void*>(mpEnd)) T();
+            ++mpEnd;
+            store_size();
+            return *(mpEnd - 1);
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::push_back(const value_type& value)
+        {
+            // value может лежать в этой же колонке.
+            const value_type copy(value);
+            if (mpEnd == mpCapacity)
+                grow(size() + 1);
+            *mpEnd++ = copy;
+            store_size();
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::push_back(value_type&& value)
+        {
+            push_back(static_cast<const value_type&>(value));
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::pop_back() noexcept
+        {
+            --mpEnd;
+            store_size();
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::resize(size_type n)
+        {
+            resize(n, T());
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::resize(size_type n, const value_type& value)
+        {
+            const size_type count = size();
+            if (n > capacity())
+                remap(n);
+            if (n > count)
+                corsac::fill(mpBegin + count, mpBegin + n, value);
+            mpEnd = mpBegin + n;
+            store_size();
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::reserve(size_type n)
+        {
+            if (n > capacity())
+                remap(n);
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::set_capacity(size_type n)
+        {
+            if (n == npos)
+                n = size();
+            if (n < size())
+                resize(n);
+            remap(n);
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::shrink_to_fit()
+        {
+            if (size() != capacity())
+                remap(size());
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::clear() noexcept
+        {
+            mpEnd = mpBegin;
+            store_size();
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::reset_lose_memory() noexcept
+        {
+            mpBegin = mpEnd = mpCapacity = nullptr;
+            region = nullptr;
+            length = 0;
+            fd = -1;
+        }
+
+        template<typename T>
+        inline bool mapped_vector<T>::open(const char* path)
+        {
+        #if CORSAC_ECS_MMAP_ENABLED
+            const int file = ::open(path, O_RDWR | O_CREAT, 0644);
+            if (file < 0)
+                return false;
+            struct stat info {};
+            mapped_header header {};
+            const size_type fileSize = ::fstat(file, &info) == 0 ? static_cast<size_type>(info.st_size) : npos;
+            const bool existing = read_header(file, fileSize, header);
+            if (!existing && fileSize != 0)
+            {
+                ::close(file);
+                return false;
+            }
+
+            const size_type mappedLength = existing ? fileSize : bytes_for(corsac::max(capacity(), size_type(1)));
+            if ((!existing && ::ftruncate(file, static_cast<off_t>(mappedLength)) != 0))
+            {
+                ::close(file);
+                return false;
+            }
+            void* mapped = ::mmap(nullptr, mappedLength, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            if (mapped == MAP_FAILED)
+            {
+                ::close(file);
+                return false;
+            }
+
+            T* first = reinterpret_cast<T*>(static_cast<uint8_t*>(mapped) + mapped_header_size);
+            const size_type count = existing ? static_cast<size_type>(header.count) : size();
+            if (!existing && count != 0)
+                std::memcpy(first, mpBegin, count * sizeof(T));
+            release();
+            region = mapped;
+            length = mappedLength;
+            fd = file;
+            mpBegin = first;
+            mpEnd = first + count;
+            mpCapacity = first + (mappedLength - mapped_header_size) / sizeof(T);
+            store_size();
+            return true;
+        #else
+            (void)path;
+            return false;
+        #endif
+        }
+
+        template<typename T>
+        inline bool mapped_vector<T>::accepts(const char* path)
+        {
+        #if CORSAC_ECS_MMAP_ENABLED
+            const int file = ::open(path, O_RDONLY);
+            if (file < 0)
+                return errno == ENOENT;
+            struct stat info {};
+            mapped_header header {};
+            const size_type fileSize = ::fstat(file, &info) == 0 ? static_cast<size_type>(info.st_size) : npos;
+            const bool accepted = fileSize == 0 || read_header(file, fileSize, header);
+            ::close(file);
+            return accepted;
+        #else
+            (void)path;
+            return false;
+        #endif
+        }
+
+        template<typename T>
+        inline bool mapped_vector<T>::read_header(int file, size_type fileSize, mapped_header& header) noexcept
+        {
+        #if CORSAC_ECS_MMAP_ENABLED
+            return fileSize != npos && fileSize >= mapped_header_size
+                    && ::pread(file, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+                    && header.magic == mapped_header::magic_value && header.element_size == sizeof(T)
+                    && header.count <= (fileSize - mapped_header_size) / sizeof(T);
+        #else
+            (void)file; (void)fileSize; (void)header;
+            return false;
+        #endif
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::close()
+        {
+            if (fd == -1)
+                return;
+            mapped_vector copy(*this);
+            *this = corsac::move(copy);
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::sync() noexcept
+        {
+        #if CORSAC_ECS_MMAP_ENABLED
+            if (fd != -1)
+                ::msync(region, length, MS_SYNC);
+        #endif
+        }
+
+        template<typename T>
+        inline typename mapped_vector<T>::size_type mapped_vector<T>::page_size() noexcept
+        {
+        #if CORSAC_ECS_MMAP_ENABLED
+            static const size_type size = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+            return size;
+        #else
+            return mapped_header_size;
+        #endif
+        }
+
+        template<typename T>
+        inline typename mapped_vector<T>::size_type mapped_vector<T>::bytes_for(size_type n) noexcept
+        {
+            const size_type page = page_size();
+            return (mapped_header_size + n * sizeof(T) + page - 1) / page * page;
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::grow(size_type n)
+        {
+            remap(corsac::max(n, capacity() * 2));
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::remap(size_type n)
+        {
+            const size_type count = corsac::min(size(), n);
+            const size_type newLength = bytes_for(n);
+            if (newLength == length && region)
+                return;
+            void* mapped = nullptr;
+        #if CORSAC_ECS_MMAP_ENABLED
+            if (fd != -1 && newLength > length && ::ftruncate(fd, static_cast<off_t>(newLength)) != 0)
+                mapped = MAP_FAILED;
+            else if (!region)
+                mapped = ::mmap(nullptr, newLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            else
+            {
+            #if defined(__linux__)
+                mapped = ::mremap(region, length, newLength, MREMAP_MAYMOVE);
+            #else
+                // Без mremap: файл отображается заново, анонимная память копируется.
+                if (fd != -1)
+                {
+                    ::munmap(region, length);
+                    mapped = ::mmap(nullptr, newLength, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                }
+                else
+                {
+                    mapped = ::mmap(nullptr, newLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (mapped != MAP_FAILED)
+                    {
+                        std::memcpy(mapped, region, corsac::min(length, newLength));
+                        ::munmap(region, length);
+                    }
+                }
+            #endif
+            }
+            if (mapped == MAP_FAILED)
+                mapped = nullptr;
+        #else
+            mapped = ::operator new(newLength, std::nothrow);
+            if (mapped && region)
+            {
+                std::memcpy(mapped, region, corsac::min(length, newLength));
+                ::operator delete(region);
+            }
+        #endif
+        #if CORSAC_EXCEPTIONS_ENABLED
+            if(CORSAC_UNLIKELY(!mapped))
+                throw std::bad_alloc();
+        #elif CORSAC_ASSERT_ENABLED
+            if(CORSAC_UNLIKELY(!mapped))
+                CORSAC_FAIL_MSG("mapped_vector::remap -- mapping failed");
+        #endif
+            if (!mapped)
+                return;
+        #if CORSAC_ECS_MMAP_ENABLED
+            if (fd != -1 && newLength < length)
+                (void)::ftruncate(fd, static_cast<off_t>(newLength));
+        #endif
+            region = mapped;
+            length = newLength;
+            mpBegin = reinterpret_cast<T*>(static_cast<uint8_t*>(mapped) + mapped_header_size);
+            mpEnd = mpBegin + count;
+            mpCapacity = mpBegin + (newLength - mapped_header_size) / sizeof(T);
+            store_size();
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::store_size() noexcept
+        {
+            if (!region)
+                return;
+            auto* header = static_cast<mapped_header*>(region);
+            header->magic = mapped_header::magic_value;
+            header->element_size = static_cast<uint32_t>(sizeof(T));
+            header->count = static_cast<uint64_t>(size());
+        }
+
+        template<typename T>
+        inline void mapped_vector<T>::release() noexcept
+        {
+            if (!region)
+                return;
+        #if CORSAC_ECS_MMAP_ENABLED
+            ::munmap(region, length);
+            if (fd != -1)
+                ::close(fd);
+        #else
+            ::operator delete(region);
+        #endif
+            reset_lose_memory();
+        }
+
+        /**
+         * mapped_tuple_vector
+         *
+         * Колонки mapped_vector, open(path) отображает колонку I в файл "path.I".
+         */
+        template<typename... Ts>
+        class mapped_tuple_vector : public column_tuple_vector<mapped_vector<Ts>...>
+        {
+        public:
+            bool open(const char* path)
+            {
+                bool opened = true;
+                size_t column = 0;
+                this->each([path, &opened, &column](auto& c) {
+                    const std::string name = std::string(path) + "." + std::to_string(column++);
+                    opened = c.open(name.c_str()) && opened;
+                });
+                return opened;
+            }
+
+            // Все колонки примут свои файлы "path.I", см. mapped_vector::accepts.
+            static bool accepts(const char* path)
+            {
+                size_t column = 0;
+                return ((mapped_vector<Ts>::accepts((std::string(path) + "." + std::to_string(column++)).c_str())) && ...);
+            }
+
+            void close()
+            {
+                this->each([](auto& column) { column.close(); });
+            }
+
+            void sync() noexcept
+            {
+                corsac::apply([](auto&... column) { (column.sync(), ...); }, this->columns);
+            }
+
+            // Длина, общая для всех колонок после open(): колонки, записанные не до конца, обрезаются.
+            [[nodiscard]] size_t common_size() const noexcept
+            {
+                size_t n = static_cast<size_t>(-1);
+                corsac::apply([&n](const auto&... column) { ((n = corsac::min(n, column.size())), ...); }, this->columns);
+                return n;
+            }
+        };
+    }
+}
+
+#endif //CORSAC_ECS_MAPPED_VECTOR_H
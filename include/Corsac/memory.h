@@ -0,0 +1,390 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_MEMORY_H
+#define CORSAC_ECS_MEMORY_H
+
+#include "Corsac/type_traits.h"
+#include "Corsac/algorithm.h"
+#include "Corsac/vector.h"
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#ifndef CORSAC_ECS_ARENA_BLOCK_SIZE
+    #define CORSAC_ECS_ARENA_BLOCK_SIZE 65536
+#endif
+
+#ifndef CORSAC_ECS_POOL_MAX_CLASS
+    #define CORSAC_ECS_POOL_MAX_CLASS 1048576
+#endif
+
+namespace corsac
+{
+    namespace internal
+    {
+        // Аллокатор контейнеров Corsac_STL по умолчанию, им пользуются хранилища без параметра Allocator.
+        using default_allocator = typename corsac::vector<uint8_t>::allocator_type;
+
+        // Выравнивание блоков пула: блок класса size выровнен по min(size, pool_alignment).
+        static constexpr size_t pool_alignment = 64;
+
+        inline constexpr bool is_power_of_two(size_t value) noexcept
+        {
+            return value != 0 && (value & (value - 1)) == 0;
+        }
+    }
+
+    /**
+     * MemoryUsage
+     *
+     * Отчет memory_usage() хранилища, группы или мира в байтах. used - под живыми
+     * элементами, capacity - выделено (для sparse - страницы и таблица страниц целиком).
+     * other - тики, сигнатуры реестра и слоты аллокатора сущностей. Отчеты складываются
+     * через +=, max_id - наибольший индекс живой сущности плюс 1.
+     */
+    struct MemoryUsage
+    {
+        size_t sparse_used     = 0;
+        size_t sparse_capacity = 0;
+        size_t packed_used     = 0;
+        size_t packed_capacity = 0;
+        size_t values_used     = 0;
+        size_t values_capacity = 0;
+        size_t other_used      = 0;
+        size_t other_capacity  = 0;
+        size_t entities        = 0;
+        size_t max_id          = 0;
+
+        [[nodiscard]] size_t used() const noexcept
+        {
+            return sparse_used + packed_used + values_used + other_used;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return sparse_capacity + packed_capacity + values_capacity + other_capacity;
+        }
+
+        // Доля живых сущностей в диапазоне ID [0, max_id): чем меньше, тем больше пустых страниц sparse.
+        [[nodiscard]] double density() const noexcept
+        {
+            return max_id ? static_cast<double>(entities) / static_cast<double>(max_id) : 1.0;
+        }
+
+        MemoryUsage& operator+=(const MemoryUsage& x) noexcept
+        {
+            sparse_used     += x.sparse_used;
+            sparse_capacity += x.sparse_capacity;
+            packed_used     += x.packed_used;
+            packed_capacity += x.packed_capacity;
+            values_used     += x.values_used;
+            values_capacity += x.values_capacity;
+            other_used      += x.other_used;
+            other_capacity  += x.other_capacity;
+            entities        += x.entities;
+            max_id           = corsac::max(max_id, x.max_id);
+            return *this;
+        }
+    };
+
+    /**
+     * ArenaResource
+     *
+     * Монотонная арена: память выдается сдвигом указателя в блоках по blockSize байт,
+     * deallocate ничего не делает, а release() возвращает все блоки разом. Запросы больше
+     * половины блока получают собственный блок, текущий при этом не бросается.
+     */
+    class ArenaResource
+    {
+        struct block
+        {
+            block* next;
+            size_t size;
+        };
+
+    protected:
+        block*     head      = nullptr;
+        uint8_t*   cursor    = nullptr;
+        uint8_t*   last      = nullptr;
+        size_t     blockSize = CORSAC_ECS_ARENA_BLOCK_SIZE;
+        size_t     usedBytes = 0;
+        size_t     reservedBytes = 0;
+        std::mutex mutex;
+
+    public:
+        explicit ArenaResource(size_t blockSize = CORSAC_ECS_ARENA_BLOCK_SIZE) noexcept;
+        ArenaResource(const ArenaResource&) = delete;
+        ArenaResource& operator=(const ArenaResource&) = delete;
+        ~ArenaResource();
+
+        // alignment - степень двойки, выравнивается адрес p + offset.
+        void* allocate(size_t n, size_t alignment = alignof(std::max_align_t), size_t offset = 0);
+        void  deallocate(void* p, size_t n) noexcept;
+
+        // Освобождает все блоки. Контейнеры, получившие из арены память, должны забыть ее
+        // через reset_lose_memory() до следующей вставки.
+        void release() noexcept;
+
+        [[nodiscard]] size_t used() const noexcept;
+        [[nodiscard]] size_t reserved() const noexcept;
+
+    private:
+        uint8_t* add_block(size_t size);
+    };
+
+    inline ArenaResource::ArenaResource(size_t blockSize) noexcept
+        : blockSize(corsac::max(blockSize, size_t(256)))
+    {}
+
+    inline ArenaResource::~ArenaResource()
+    {
+        release();
+    }
+
+    inline void* ArenaResource::allocate(size_t n, size_t alignment, size_t offset)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        const size_t mask = alignment - 1;
+        auto aligned = [mask, offset](uint8_t* p) {
+            return p + ((mask + 1 - ((reinterpret_cast<uintptr_t>(p) + offset) & mask)) & mask);
+        };
+
+        uint8_t* p = cursor ? aligned(cursor) : nullptr;
+        if (!p || p > last || static_cast<size_t>(last - p) < n)
+        {
+            const size_t size = sizeof(block) + n + alignment;
+            if (size > blockSize / 2)
+            {
+                // Отдельный блок, текущий продолжает раздаваться.
+                uint8_t* first = add_block(size);
+                if (!first)
+                    return nullptr;
+                usedBytes += n;
+                return aligned(first);
+            }
+            cursor = add_block(blockSize);
+            if (!cursor)
+                return nullptr;
+            last = cursor + (blockSize - sizeof(block));
+            p = aligned(cursor);
+        }
+        cursor = p + n;
+        usedBytes += n;
+        return p;
+    }
+
+    inline void ArenaResource::deallocate(void*, size_t) noexcept
+    {}
+
+    inline void ArenaResource::release() noexcept
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        while (head)
+        {
+            block* next = head->next;
+            ::operator delete(head);
+            head = next;
+        }
+        cursor = last = nullptr;
+        usedBytes = reservedBytes = 0;
+    }
+
+    inline size_t ArenaResource::used() const noexcept
+    {
+        return usedBytes;
+    }
+
+    inline size_t ArenaResource::reserved() const noexcept
+    {
+        return reservedBytes;
+    }
+
+    inline uint8_t* ArenaResource::add_block(size_t size)
+    {
+        auto* memory = static_cast<block*>(::operator new(size, std::nothrow));
+    #if CORSAC_EXCEPTIONS_ENABLED
+        if(CORSAC_UNLIKELY(!memory))
+            throw std::bad_alloc();
+    #elif CORSAC_ASSERT_ENABLED
+        if(CORSAC_UNLIKELY(!memory))
+            CORSAC_FAIL_MSG("ArenaResource::allocate -- out of memory");
+    #endif
+        if (!memory)
+            return nullptr;
+        memory->next = head;
+        memory->size = size;
+        head = memory;
+        reservedBytes += size;
+        return reinterpret_cast<uint8_t*>(memory + 1);
+    }
+
+    /**
+     * PoolResource
+     *
+     * Пул классов размеров: запрос округляется до степени двойки от 16 до CORSAC_ECS_POOL_MAX_CLASS
+     * байт, освобожденные блоки ждут в списке своего класса, новые нарезаются из ArenaResource.
+     * Рост vector отдает старый буфер, и следующий контейнер того же класса берет его без кучи.
+     * Блоки больше CORSAC_ECS_POOL_MAX_CLASS берутся прямо из арены и возвращаются только release().
+     */
+    class PoolResource
+    {
+        struct node
+        {
+            node* next;
+        };
+
+        static constexpr size_t min_class   = 16;
+        static constexpr size_t class_count = [] {
+            size_t count = 1;
+            for (size_t size = min_class; size < CORSAC_ECS_POOL_MAX_CLASS; size *= 2)
+                ++count;
+            return count;
+        }();
+
+        static_assert(internal::is_power_of_two(CORSAC_ECS_POOL_MAX_CLASS) && CORSAC_ECS_POOL_MAX_CLASS >= min_class,
+                      "CORSAC_ECS_POOL_MAX_CLASS must be a power of two not less than 16");
+
+    protected:
+        node*         lists[class_count] = {};
+        ArenaResource arena;
+        std::mutex    mutex;
+
+    public:
+        explicit PoolResource(size_t blockSize = CORSAC_ECS_ARENA_BLOCK_SIZE) noexcept;
+
+        void* allocate(size_t n, size_t alignment = alignof(std::max_align_t), size_t offset = 0);
+        void  deallocate(void* p, size_t n) noexcept;
+
+        // Возвращает всю память пула, см. ArenaResource::release().
+        void release() noexcept;
+
+        [[nodiscard]] size_t reserved() const noexcept;
+
+    private:
+        static size_t class_of(size_t n) noexcept;
+    };
+
+    inline PoolResource::PoolResource(size_t blockSize) noexcept
+        : arena(blockSize)
+    {}
+
+    inline void* PoolResource::allocate(size_t n, size_t alignment, size_t offset)
+    {
+        if (n > CORSAC_ECS_POOL_MAX_CLASS)
+            return arena.allocate(n, alignment, offset);
+        const size_t index = class_of(n);
+        const size_t size = min_class << index;
+        const size_t natural = corsac::min(size, internal::pool_alignment);
+        if (alignment > natural || offset != 0)
+            return arena.allocate(size, alignment, offset);
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (node* free = lists[index])
+            {
+                lists[index] = free->next;
+                return free;
+            }
+        }
+        return arena.allocate(size, natural);
+    }
+
+    inline void PoolResource::deallocate(void* p, size_t n) noexcept
+    {
+        // Блок с особым выравниванием тоже занимает весь класс и годится для обычных запросов.
+        if (!p || n > CORSAC_ECS_POOL_MAX_CLASS)
+            return;
+        const size_t index = class_of(n);
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto* free = static_cast<node*>(p);
+        free->next = lists[index];
+        lists[index] = free;
+    }
+
+    inline void PoolResource::release() noexcept
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            for (node*& list : lists)
+                list = nullptr;
+        }
+        arena.release();
+    }
+
+    inline size_t PoolResource::reserved() const noexcept
+    {
+        return arena.reserved();
+    }
+
+    inline size_t PoolResource::class_of(size_t n) noexcept
+    {
+        size_t index = 0;
+        for (size_t size = min_class; size < n; size *= 2)
+            ++index;
+        return index;
+    }
+
+    /**
+     * resource_allocator
+     *
+     * Аллокатор контейнеров Corsac_STL поверх общего на Scene экземпляра Resource, поэтому
+     * все хранилища с одним Scene берут память из одной области:
+     *
+     * struct Level {};
+     * corsac::Component<float, float>::Config<corsac::DYNAMIC, 0, corsac::ArenaAllocator<Level>> Position;
+     * ...
+     * Position.reset_lose_memory();                    // хранилища забывают память
+     * corsac::ArenaAllocator<Level>::resource().release(); // одна операция на всю сцену
+     *
+     * Ресурс не разрушается до конца процесса: глобальные хранилища могут освобождать
+     * память в своих деструкторах после него.
+     */
+    template<typename Resource, typename Scene = Resource>
+    class resource_allocator
+    {
+    public:
+        explicit resource_allocator(const char* = nullptr) noexcept {}
+        resource_allocator(const resource_allocator&, const char*) noexcept {}
+
+        static Resource& resource() noexcept
+        {
+            static Resource& instance = *new Resource();
+            return instance;
+        }
+
+        void* allocate(size_t n, int = 0)
+        {
+            return resource().allocate(n);
+        }
+
+        void* allocate(size_t n, size_t alignment, size_t offset, int = 0)
+        {
+            return resource().allocate(n, corsac::max(alignment, size_t(1)), offset);
+        }
+
+        void deallocate(void* p, size_t n)
+        {
+            resource().deallocate(p, n);
+        }
+
+        [[nodiscard]] const char* get_name() const noexcept
+        {
+            return "corsac::resource_allocator";
+        }
+
+        void set_name(const char*) noexcept {}
+
+        friend bool operator==(const resource_allocator&, const resource_allocator&) noexcept { return true; }
+        friend bool operator!=(const resource_allocator&, const resource_allocator&) noexcept { return false; }
+    };
+
+    template<typename Scene>
+    using ArenaAllocator = resource_allocator<ArenaResource, Scene>;
+
+    template<typename Scene>
+    using PoolAllocator = resource_allocator<PoolResource, Scene>;
+}
+
+#endif //CORSAC_ECS_MEMORY_H
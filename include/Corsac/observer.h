@@ -0,0 +1,275 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_OBSERVER_H
+#define CORSAC_ECS_OBSERVER_H
+
+#include "Corsac/entity.h"
+#include "Corsac/vector.h"
+
+#include <functional>
+
+namespace corsac
+{
+    /**
+     * Signal
+     *
+     * Список слушателей пакета сущностей: f(const EntityType* ids, size_t n).
+     * Одиночные операции приходят пакетом из одного ID.
+     */
+    class Signal
+    {
+    public:
+        using size_type     = size_t;
+        using listener_type = std::function<void(const EntityType*, size_type)>;
+
+    protected:
+        corsac::vector<listener_type> listeners;
+        size_type                     count = 0;
+
+    public:
+        Signal() noexcept = default;
+
+        // Возвращает номер слушателя для disconnect().
+        template<typename F>
+        size_type connect(F&& f);
+
+        void disconnect(size_type n) noexcept;
+        void clear() noexcept;
+
+        [[nodiscard]] bool empty() const noexcept;
+
+        void operator()(const EntityType* ids, size_type n) const;
+    };
+
+    template<typename F>
+    inline Signal::size_type Signal::connect(F&& f)
+    {
+        listeners.push_back(listener_type(corsac::forward<F>(f)));
+        ++count;
+        return listeners.size() - 1;
+    }
+
+    inline void Signal::disconnect(size_type n) noexcept
+    {
+        if (n < listeners.size() && listeners[n])
+        {
+            listeners[n] = nullptr;
+            --count;
+        }
+    }
+
+    inline void Signal::clear() noexcept
+    {
+        listeners.clear();
+        count = 0;
+    }
+
+    inline bool Signal::empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    inline void Signal::operator()(const EntityType* ids, size_type n) const
+    {
+        for (const listener_type& listener : listeners)
+        {
+            if (listener)
+                listener(ids, n);
+        }
+    }
+
+    /**
+     * Observed
+     *
+     * Хранилище (компонент или группа) с сигналами on_add, on_update и on_remove.
+     * Обычные хранилища сигналов не знают, их add/remove не меняются.
+     *
+     * corsac::Observed<corsac::Component<float, float>> Position;
+     * Position.on_add().connect([](const corsac::EntityType* ids, size_t n) { ... });
+     *
+     * on_add и on_update приходят после записи значений, on_remove - до удаления.
+     * add_n отдает новые сущности одним пакетом. Между hold() и release() on_add и on_update
+     * копятся и приходят по пакету на сигнал, так их получает CommandBuffer::flush().
+     * on_remove всегда приходит сразу, пока значения еще доступны.
+     */
+    template<typename Storage>
+    class Observed : public Storage
+    {
+        using base_type = Storage;
+
+    public:
+        using size_type = size_t;
+        using base_type::has;
+
+    protected:
+        Signal                     added;
+        Signal                     updated;
+        Signal                     removed;
+        corsac::vector<EntityType> pendingAdded;
+        corsac::vector<EntityType> pendingUpdated;
+        size_type                  holds = 0;
+
+    public:
+        Observed();
+
+        Signal& on_add() noexcept;
+        Signal& on_update() noexcept;
+        Signal& on_remove() noexcept;
+
+        template<typename ...Args>
+        void add(const EntityType& value, Args&&... data);
+
+        template<typename ...Args>
+        size_type add_n(const EntityType* ids, size_type n, Args&&... data);
+
+        template<typename ...Args>
+        void set(const EntityType& value, Args&&... data);
+
+        template<typename ...Args>
+        void fit(const EntityType& value, Args&&... data);
+
+        void remove(const EntityType& value);
+
+        // Откладывает on_add и on_update до парного release().
+        void hold() noexcept;
+        void release();
+
+    private:
+        void emit(Signal& signal, corsac::vector<EntityType>& pending, const EntityType* ids, size_type n);
+    };
+
+    template<typename Storage>
+    inline Observed<Storage>::Observed()
+    {
+        // destroy() через реестр должен идти через remove() обертки.
+        if constexpr (Storage::component_type == internal::CHUNK)
+            this->entry.enroll_overflow(this);
+        else
+            this->entry.enroll(this);
+    }
+
+    template<typename Storage>
+    inline Signal& Observed<Storage>::on_add() noexcept
+    {
+        return added;
+    }
+
+    template<typename Storage>
+    inline Signal& Observed<Storage>::on_update() noexcept
+    {
+        return updated;
+    }
+
+    template<typename Storage>
+    inline Signal& Observed<Storage>::on_remove() noexcept
+    {
+        return removed;
+    }
+
+    template<typename Storage>
+    template<typename ...Args>
+    inline void Observed<Storage>::add(const EntityType& value, Args&&... data)
+    {
+        const bool fresh = !has(value);
+        base_type::add(value, corsac::forward<Args>(data)...);
+        if (fresh)
+            emit(added, pendingAdded, &value, 1);
+    }
+
+    template<typename Storage>
+    template<typename ...Args>
+    inline typename Observed<Storage>::size_type
+    Observed<Storage>::add_n(const EntityType* ids, size_type n, Args&&... data)
+    {
+        const size_type count = base_type::size();
+        const size_type result = base_type::add_n(ids, n, corsac::forward<Args>(data)...);
+        // Новые сущности лежат в хвосте packed одним блоком.
+        if (result != 0)
+            emit(added, pendingAdded, base_type::entities() + count, result);
+        return result;
+    }
+
+    template<typename Storage>
+    template<typename ...Args>
+    inline void Observed<Storage>::set(const EntityType& value, Args&&... data)
+    {
+        const bool fresh = !has(value);
+        base_type::set(value, corsac::forward<Args>(data)...);
+        if (fresh)
+            emit(added, pendingAdded, &value, 1);
+        else
+            emit(updated, pendingUpdated, &value, 1);
+    }
+
+    template<typename Storage>
+    template<typename ...Args>
+    inline void Observed<Storage>::fit(const EntityType& value, Args&&... data)
+    {
+        base_type::fit(value, corsac::forward<Args>(data)...);
+        emit(updated, pendingUpdated, &value, 1);
+    }
+
+    template<typename Storage>
+    inline void Observed<Storage>::remove(const EntityType& value)
+    {
+        if (!removed.empty() && has(value))
+            removed(&value, 1);
+        base_type::remove(value);
+    }
+
+    template<typename Storage>
+    inline void Observed<Storage>::hold() noexcept
+    {
+        ++holds;
+    }
+
+    template<typename Storage>
+    inline void Observed<Storage>::release()
+    {
+        if (holds == 0 || --holds != 0)
+            return;
+        if (!pendingAdded.empty())
+            added(pendingAdded.data(), pendingAdded.size());
+        if (!pendingUpdated.empty())
+            updated(pendingUpdated.data(), pendingUpdated.size());
+        pendingAdded.clear();
+        pendingUpdated.clear();
+    }
+
+    template<typename Storage>
+    inline void Observed<Storage>::emit(Signal& signal, corsac::vector<EntityType>& pending, const EntityType* ids, size_type n)
+    {
+        if (signal.empty())
+            return;
+        if (holds != 0)
+            pending.insert(pending.end(), ids, ids + n);
+        else
+            signal(ids, n);
+    }
+
+    namespace internal
+    {
+        // Пакетная доставка сигналов на время применения отложенных команд.
+        template<typename Storage>
+        inline void hold_signals(Storage&) noexcept {}
+
+        template<typename Storage>
+        inline void hold_signals(Observed<Storage>& storage) noexcept
+        {
+            storage.hold();
+        }
+
+        template<typename Storage>
+        inline void release_signals(Storage&) noexcept {}
+
+        template<typename Storage>
+        inline void release_signals(Observed<Storage>& storage)
+        {
+            storage.release();
+        }
+    }
+}
+
+#endif //CORSAC_ECS_OBSERVER_H
@@ -0,0 +1,452 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_REGISTRY_H
+#define CORSAC_ECS_REGISTRY_H
+
+#include "Corsac/algorithm.h"
+#include "Corsac/entity.h"
+#include "Corsac/vector.h"
+
+#include <atomic>
+
+#ifndef CORSAC_ECS_MAX_COMPONENTS
+    #define CORSAC_ECS_MAX_COMPONENTS 64
+#endif
+
+namespace corsac
+{
+    namespace internal
+    {
+        static constexpr size_t registry_npos = static_cast<size_t>(-1);
+
+        /**
+         * signature
+         *
+         * Набор хранилищ, в которых есть сущность owner: по биту на зарегистрированное хранилище.
+         */
+        struct signature
+        {
+            static constexpr size_t word_count = (CORSAC_ECS_MAX_COMPONENTS + 63) / 64;
+
+            EntityType owner = entity_traits<EntityType>::null;
+            uint64_t   words[word_count] = {};
+
+            void set(size_t bit) noexcept
+            {
+                words[bit / 64] |= uint64_t(1) << (bit % 64);
+            }
+
+            void reset(size_t bit) noexcept
+            {
+                words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+            }
+
+            [[nodiscard]] bool test(size_t bit) const noexcept
+            {
+                return (words[bit / 64] >> (bit % 64)) & 1u;
+            }
+
+            // Все биты mask есть в этой сигнатуре.
+            [[nodiscard]] bool contains(const signature& mask) const noexcept
+            {
+                for (size_t i = 0; i < word_count; ++i)
+                {
+                    if ((words[i] & mask.words[i]) != mask.words[i])
+                        return false;
+                }
+                return true;
+            }
+        };
+
+        /**
+         * shared_signature
+         *
+         * Сигнатура в реестре: owner и биты меняются атомарно, поэтому системы, пишущие
+         * в разные хранилища, отмечают add/remove одной сущности одновременно.
+         */
+        struct shared_signature
+        {
+            std::atomic<EntityType> owner{entity_traits<EntityType>::null};
+            std::atomic<uint64_t>   words[signature::word_count] = {};
+        };
+
+        // Номер младшего установленного бита, bits != 0.
+        inline size_t lowest_bit(uint64_t bits) noexcept
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return static_cast<size_t>(__builtin_ctzll(bits));
+        #else
+            size_t bit = 0;
+            for (; ((bits >> bit) & 1u) == 0; ++bit) {}
+            return bit;
+        #endif
+        }
+
+        /**
+         * registry
+         *
+         * Сигнатуры живых сущностей по индексной части ID. Хранилища получают бит при создании
+         * и отмечают в нем add/remove, поэтому проверка нескольких компонентов - одно сравнение
+         * масок, а уничтожение сущности обходит только хранилища, в которых она есть.
+         * Хранилища сверх CORSAC_ECS_MAX_COMPONENTS бит не получают: destroy() обходит их
+         * списком overflow целиком, а проверки по маске для них идут через само хранилище.
+         * Бит выдается первый свободный, поэтому порядок destroy() задает ранг хранилища:
+         * у компонента 0, у группы на 1 больше, чем у старшего из ее участников.
+         * Сигнатуры лежат страницами, которые не переезжают при росте: set/reset из разных потоков
+         * для разных хранилищ безопасны. enroll/withdraw и destroy - без параллельных изменений.
+         */
+        class registry
+        {
+            using remover_type = void(*)(void*, const EntityType&);
+
+            static constexpr size_t page_size  = 4096;
+            static constexpr size_t page_count = (static_cast<size_t>(entity_traits<EntityType>::index_mask) + page_size) / page_size;
+            // Владелец на время очистки сигнатуры под новую версию: индекс index_mask не выдается.
+            static constexpr EntityType busy   = static_cast<EntityType>(~EntityType(0));
+
+            struct slot
+            {
+                void*        storage = nullptr;
+                remover_type remove  = nullptr;
+                size_t       rank    = 0;
+            };
+
+        protected:
+            std::atomic<shared_signature*> pages[page_count] = {};
+            slot                           slots[CORSAC_ECS_MAX_COMPONENTS];
+            corsac::vector<slot>           overflow;     // хранилища без бита, в порядке создания
+            size_t                         depth = 0;    // старший ранг среди зарегистрированных
+
+            [[nodiscard]] shared_signature* find(const EntityType& value) const noexcept;
+            shared_signature&               assure(const EntityType& value);
+
+        public:
+            registry() noexcept = default;
+            ~registry();
+
+            registry(const registry&) = delete;
+            registry& operator=(const registry&) = delete;
+
+            // Свободный бит для хранилища или registry_npos.
+            size_t enroll(void* storage, remover_type remove, size_t rank) noexcept;
+            void   rebind(size_t bit, void* storage, remover_type remove) noexcept;
+            void   withdraw(size_t bit) noexcept;
+
+            // Хранилище без бита, destroy() снимает с него любую сущность.
+            void enroll_overflow(void* storage, remover_type remove, size_t rank);
+            void rebind_overflow(void* previous, void* storage, remover_type remove) noexcept;
+            void withdraw_overflow(void* storage) noexcept;
+
+            void set(const EntityType& value, size_t bit);
+            void reset(const EntityType& value, size_t bit) noexcept;
+
+            // Сигнатура сущности, пустая для неизвестных ID и устаревших версий.
+            [[nodiscard]] signature of(const EntityType& value) const noexcept;
+            [[nodiscard]] bool      has(const EntityType& value, const signature& mask) const noexcept;
+
+            // Удаляет сущность из всех зарегистрированных хранилищ, в которых она есть,
+            // от старших рангов к младшим: группа раньше своих участников.
+            void destroy(const EntityType& value);
+
+            // Страницы сигнатур и их таблица в other.
+            [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+        };
+
+        inline registry::~registry()
+        {
+            for (std::atomic<shared_signature*>& page : pages)
+                delete[] page.load(std::memory_order_relaxed);
+        }
+
+        inline shared_signature* registry::find(const EntityType& value) const noexcept
+        {
+            const size_t index = entity_traits<EntityType>::index(value);
+            shared_signature* page = pages[index / page_size].load(std::memory_order_acquire);
+            return page ? page + index % page_size : nullptr;
+        }
+
+        inline shared_signature& registry::assure(const EntityType& value)
+        {
+            const size_t index = entity_traits<EntityType>::index(value);
+            std::atomic<shared_signature*>& target = pages[index / page_size];
+            shared_signature* page = target.load(std::memory_order_acquire);
+            if (!page)
+            {
+                // Страница ставится один раз, поток, проигравший гонку, удаляет свою.
+                shared_signature* created = new shared_signature[page_size];
+                if (target.compare_exchange_strong(page, created, std::memory_order_acq_rel, std::memory_order_acquire))
+                    page = created;
+                else
+                    delete[] created;
+            }
+            return page[index % page_size];
+        }
+
+        inline size_t registry::enroll(void* storage, remover_type remove, size_t rank) noexcept
+        {
+            for (size_t bit = 0; bit < CORSAC_ECS_MAX_COMPONENTS; ++bit)
+            {
+                if (!slots[bit].storage)
+                {
+                    slots[bit] = slot{storage, remove, rank};
+                    depth = corsac::max(depth, rank);
+                    return bit;
+                }
+            }
+            return registry_npos;
+        }
+
+        inline void registry::rebind(size_t bit, void* storage, remover_type remove) noexcept
+        {
+            slots[bit].storage = storage;
+            slots[bit].remove  = remove;
+        }
+
+        inline void registry::withdraw(size_t bit) noexcept
+        {
+            slots[bit] = slot();
+            const uint64_t mask = ~(uint64_t(1) << (bit % 64));
+            for (std::atomic<shared_signature*>& page : pages)
+            {
+                shared_signature* first = page.load(std::memory_order_acquire);
+                for (size_t i = 0; first && i < page_size; ++i)
+                    first[i].words[bit / 64].fetch_and(mask, std::memory_order_relaxed);
+            }
+        }
+
+        inline void registry::enroll_overflow(void* storage, remover_type remove, size_t rank)
+        {
+            overflow.push_back(slot{storage, remove, rank});
+            depth = corsac::max(depth, rank);
+        }
+
+        inline void registry::rebind_overflow(void* previous, void* storage, remover_type remove) noexcept
+        {
+            for (slot& s : overflow)
+            {
+                if (s.storage == previous)
+                {
+                    s.storage = storage;
+                    s.remove  = remove;
+                }
+            }
+        }
+
+        inline void registry::withdraw_overflow(void* storage) noexcept
+        {
+            for (size_t i = 0; i < overflow.size(); ++i)
+            {
+                if (overflow[i].storage == storage)
+                {
+                    overflow.erase(overflow.begin() + static_cast<ptrdiff_t>(i));
+                    return;
+                }
+            }
+        }
+
+        inline void registry::set(const EntityType& value, size_t bit)
+        {
+            shared_signature& s = assure(value);
+            // Новая версия индекса начинает с пустой сигнатуры: ее очищает поток, занявший owner,
+            // остальные ждут, пока он не запишет новую версию.
+            for (EntityType owner = s.owner.load(std::memory_order_acquire); owner != value;)
+            {
+                if (owner != busy && s.owner.compare_exchange_weak(owner, busy, std::memory_order_acquire))
+                {
+                    for (std::atomic<uint64_t>& word : s.words)
+                        word.store(0, std::memory_order_relaxed);
+                    s.owner.store(value, std::memory_order_release);
+                    break;
+                }
+                owner = s.owner.load(std::memory_order_acquire);
+            }
+            s.words[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_relaxed);
+        }
+
+        inline void registry::reset(const EntityType& value, size_t bit) noexcept
+        {
+            shared_signature* s = find(value);
+            if (s && s->owner.load(std::memory_order_acquire) == value)
+                s->words[bit / 64].fetch_and(~(uint64_t(1) << (bit % 64)), std::memory_order_relaxed);
+        }
+
+        inline signature registry::of(const EntityType& value) const noexcept
+        {
+            signature result;
+            const shared_signature* s = find(value);
+            if (s && s->owner.load(std::memory_order_acquire) == value)
+            {
+                result.owner = value;
+                for (size_t i = 0; i < signature::word_count; ++i)
+                    result.words[i] = s->words[i].load(std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        inline bool registry::has(const EntityType& value, const signature& mask) const noexcept
+        {
+            const signature s = of(value);
+            return s.owner == value && s.contains(mask);
+        }
+
+        inline void registry::destroy(const EntityType& value)
+        {
+            // Группа снимает сущность и со своих участников, поэтому их биты
+            // перепроверяются по текущей сигнатуре.
+            const signature s = of(value);
+            for (size_t rank = depth + 1; rank-- > 0;)
+            {
+                for (size_t word = 0; word < signature::word_count; ++word)
+                {
+                    for (uint64_t bits = s.words[word]; bits != 0; bits &= bits - 1)
+                    {
+                        const size_t bit = word * 64 + lowest_bit(bits);
+                        const slot& target = slots[bit];
+                        if (target.storage && target.rank == rank && of(value).test(bit))
+                            target.remove(target.storage, value);
+                    }
+                }
+                for (const slot& target : overflow)
+                {
+                    if (target.rank == rank)
+                        target.remove(target.storage, value);
+                }
+            }
+        }
+
+        inline MemoryUsage registry::memory_usage() const noexcept
+        {
+            size_t allocated = 0;
+            for (const std::atomic<shared_signature*>& page : pages)
+                allocated += page.load(std::memory_order_acquire) != nullptr;
+
+            MemoryUsage usage;
+            usage.other_used     = allocated * page_size * sizeof(shared_signature) + overflow.size() * sizeof(slot);
+            usage.other_capacity = allocated * page_size * sizeof(shared_signature) + sizeof(pages) + overflow.capacity() * sizeof(slot);
+            return usage;
+        }
+
+        inline registry& getRegistry() noexcept
+        {
+            static registry r;
+            return r;
+        }
+
+        // Реестр для хранилищ, создаваемых в этом потоке: World подставляет свой на время
+        // создания хранилищ, nullptr - общий getRegistry().
+        inline registry*& getRegistryScope() noexcept
+        {
+            static thread_local registry* scope = nullptr;
+            return scope;
+        }
+
+        /**
+         * registry_entry
+         *
+         * Бит хранилища в реестре. Копия хранилища бита не получает,
+         * при разрушении бит освобождается и сбрасывается у всех сущностей.
+         * Реестр выбирается при первом enroll: getRegistryScope() или общий.
+         * Без свободного бита хранилище попадает в список overflow реестра.
+         */
+        class registry_entry
+        {
+            size_t    id         = registry_npos;
+            size_t    level      = 0;
+            registry* owner      = nullptr;
+            void*     overflowed = nullptr;
+
+            template<typename Storage>
+            static void remove_from(void* storage, const EntityType& value)
+            {
+                static_cast<Storage*>(storage)->remove(value);
+            }
+
+        public:
+            registry_entry() noexcept = default;
+            registry_entry(const registry_entry&) noexcept {}
+            registry_entry& operator=(const registry_entry&) noexcept { return *this; }
+
+            ~registry_entry()
+            {
+                if (id != registry_npos)
+                    owner->withdraw(id);
+                else if (overflowed)
+                    owner->withdraw_overflow(overflowed);
+            }
+
+            // Повторный вызов (из обертки хранилища) перепривязывает remove к новому типу, ранг остается прежним.
+            template<typename Storage>
+            void enroll(Storage* storage, size_t rank = 0)
+            {
+                if (!owner)
+                    owner = getRegistryScope() ? getRegistryScope() : &getRegistry();
+                if (id != registry_npos)
+                    owner->rebind(id, storage, &remove_from<Storage>);
+                else if (overflowed)
+                {
+                    owner->rebind_overflow(overflowed, storage, &remove_from<Storage>);
+                    overflowed = storage;
+                }
+                else
+                {
+                    level = rank;
+                    id = owner->enroll(storage, &remove_from<Storage>, rank);
+                    if (id == registry_npos)
+                    {
+                        owner->enroll_overflow(storage, &remove_from<Storage>, rank);
+                        overflowed = storage;
+                    }
+                }
+            }
+
+            // Хранилище со своей проверкой has() (ARCHETYPE): сразу в список overflow,
+            // destroy() снимает с него любую сущность.
+            template<typename Storage>
+            void enroll_overflow(Storage* storage)
+            {
+                if (!owner)
+                    owner = getRegistryScope() ? getRegistryScope() : &getRegistry();
+                if (overflowed)
+                    owner->rebind_overflow(overflowed, storage, &remove_from<Storage>);
+                else
+                    owner->enroll_overflow(storage, &remove_from<Storage>, 0);
+                overflowed = storage;
+            }
+
+            [[nodiscard]] size_t bit() const noexcept
+            {
+                return id;
+            }
+
+            [[nodiscard]] size_t rank() const noexcept
+            {
+                return level;
+            }
+
+            void set(const EntityType& value)
+            {
+                if (id != registry_npos)
+                    owner->set(value, id);
+            }
+
+            void reset(const EntityType& value) noexcept
+            {
+                if (id != registry_npos)
+                    owner->reset(value, id);
+            }
+
+            template<typename Iterator>
+            void reset(Iterator first, Iterator last) noexcept
+            {
+                if (id == registry_npos)
+                    return;
+                for (; first != last; ++first)
+                    owner->reset(*first, id);
+            }
+        };
+    }
+}
+
+#endif //CORSAC_ECS_REGISTRY_H
@@ -0,0 +1,249 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_RUNTIME_H
+#define CORSAC_ECS_RUNTIME_H
+
+#include "Corsac/thread_pool.h"
+#include "Corsac/vector.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace corsac
+{
+    /**
+     * WorldStats
+     *
+     * Время шагов одного мира в наносекундах и номер потока, выполнившего последний шаг
+     * (см. ThreadPool::current_index, 0 - вызывающий поток).
+     */
+    struct WorldStats
+    {
+        uint64_t last      = 0;
+        uint64_t max       = 0;
+        uint64_t total     = 0;
+        uint64_t budget    = 0;     // 0 - без бюджета
+        size_t   frames    = 0;
+        size_t   overruns  = 0;     // шаги дольше budget
+        size_t   worker    = 0;
+
+        [[nodiscard]] uint64_t average() const noexcept
+        {
+            return frames ? total / frames : 0;
+        }
+    };
+
+    /**
+     * Runtime
+     *
+     * Владеет набором независимых миров WorldType и шагает их параллельно на потоках пула.
+     * Каждый кадр мир получает advance_tick() и один вызов своей функции шага. Миры
+     * раздаются потокам по одному, начиная с самых долгих по прошлому кадру, поэтому
+     * долгий мир не задерживает за собой очередь коротких, а потоки, закончившие раньше,
+     * забирают оставшиеся:
+     *
+     * using Match = corsac::World<Position, Health>;
+     * corsac::ThreadPool pool;
+     * corsac::Runtime<Match> runtime(pool);
+     * runtime.add([](Match& match) { ... }, std::chrono::milliseconds(2));
+     * runtime.run(600, std::chrono::microseconds(16667));
+     *
+     * Шаг выполняется в потоке пула: Scheduler::run(pool) внутри него сам выполняет готовые системы
+     * и не ждет освобождения своего потока.
+     */
+    template<typename WorldType>
+    class Runtime
+    {
+        using step_type = std::function<void(WorldType&)>;
+
+        struct slot
+        {
+            WorldType  world;
+            step_type  step;
+            WorldStats stats;
+        };
+
+    public:
+        using size_type  = size_t;
+        using world_type = WorldType;
+        using duration   = std::chrono::nanoseconds;
+
+    protected:
+        ThreadPool&                           pool;
+        corsac::vector<std::unique_ptr<slot>> slots;
+        corsac::vector<size_type>             order;     // порядок раздачи миров потокам
+
+    public:
+        explicit Runtime(ThreadPool& threads) noexcept;
+
+        Runtime(const Runtime&) = delete;
+        Runtime& operator=(const Runtime&) = delete;
+
+        // Новый мир с функцией шага и бюджетом кадра, возвращает номер мира.
+        template<typename F>
+        size_type add(F&& step, duration budget = duration::zero());
+
+        WorldType& world(size_type index) noexcept;
+        const WorldStats& stats(size_type index) const noexcept;
+
+        void set_budget(size_type index, duration budget) noexcept;
+
+        // Один кадр всех миров, возврат после завершения всех шагов.
+        void step();
+
+        // frames кадров с периодом period: следующий кадр начинается не раньше своего срока,
+        // отставший кадр выполняется сразу без сна.
+        void run(size_type frames, duration period);
+
+        // Сумма времени шагов последнего кадра и число миров, превысивших бюджет в нем.
+        [[nodiscard]] uint64_t  frame_time() const noexcept;
+        [[nodiscard]] size_type frame_overruns() const noexcept;
+
+        void reset_stats() noexcept;
+
+        [[nodiscard]] size_type size() const noexcept;
+
+    private:
+        void step_one(size_type index);
+        void rebalance() noexcept;
+    };
+
+    template<typename WorldType>
+    inline Runtime<WorldType>::Runtime(ThreadPool& threads) noexcept
+        : pool(threads)
+    {}
+
+    template<typename WorldType>
+    template<typename F>
+    inline typename Runtime<WorldType>::size_type Runtime<WorldType>::add(F&& step, duration budget)
+    {
+        std::unique_ptr<slot> s(new slot());
+        s->step = step_type(corsac::forward<F>(step));
+        s->stats.budget = static_cast<uint64_t>(budget.count());
+        const size_type index = slots.size();
+        slots.push_back(corsac::move(s));
+        order.push_back(index);
+        return index;
+    }
+
+    template<typename WorldType>
+    inline WorldType& Runtime<WorldType>::world(size_type index) noexcept
+    {
+        return slots[index]->world;
+    }
+
+    template<typename WorldType>
+    inline const WorldStats& Runtime<WorldType>::stats(size_type index) const noexcept
+    {
+        return slots[index]->stats;
+    }
+
+    template<typename WorldType>
+    inline void Runtime<WorldType>::set_budget(size_type index, duration budget) noexcept
+    {
+        slots[index]->stats.budget = static_cast<uint64_t>(budget.count());
+    }
+
+    template<typename WorldType>
+    inline void Runtime<WorldType>::step()
+    {
+        rebalance();
+        // Куски по одному миру выдаются по порядку order, свободный поток берет следующий.
+        pool.parallel_for(order.size(), 1, [this](size_type first, size_type last) {
+            for (size_type i = first; i < last; ++i)
+                step_one(order[i]);
+        });
+    }
+
+    template<typename WorldType>
+    inline void Runtime<WorldType>::run(size_type frames, duration period)
+    {
+        auto deadline = std::chrono::steady_clock::now();
+        for (size_type frame = 0; frame < frames; ++frame)
+        {
+            step();
+            deadline += period;
+            const auto now = std::chrono::steady_clock::now();
+            if (now < deadline)
+                std::this_thread::sleep_until(deadline);
+            else
+                deadline = now;
+        }
+    }
+
+    template<typename WorldType>
+    inline uint64_t Runtime<WorldType>::frame_time() const noexcept
+    {
+        uint64_t total = 0;
+        for (const auto& s : slots)
+            total += s->stats.last;
+        return total;
+    }
+
+    template<typename WorldType>
+    inline typename Runtime<WorldType>::size_type Runtime<WorldType>::frame_overruns() const noexcept
+    {
+        size_type count = 0;
+        for (const auto& s : slots)
+            count += s->stats.budget != 0 && s->stats.last > s->stats.budget;
+        return count;
+    }
+
+    template<typename WorldType>
+    inline void Runtime<WorldType>::reset_stats() noexcept
+    {
+        for (auto& s : slots)
+        {
+            const uint64_t budget = s->stats.budget;
+            s->stats = WorldStats();
+            s->stats.budget = budget;
+        }
+    }
+
+    template<typename WorldType>
+    inline typename Runtime<WorldType>::size_type Runtime<WorldType>::size() const noexcept
+    {
+        return slots.size();
+    }
+
+    template<typename WorldType>
+    inline void Runtime<WorldType>::step_one(size_type index)
+    {
+        slot& s = *slots[index];
+        const auto start = std::chrono::steady_clock::now();
+        s.world.advance_tick();
+        s.step(s.world);
+        const auto elapsed = std::chrono::duration_cast<duration>(std::chrono::steady_clock::now() - start);
+
+        WorldStats& stats = s.stats;
+        stats.last   = static_cast<uint64_t>(elapsed.count());
+        stats.max    = corsac::max(stats.max, stats.last);
+        stats.total += stats.last;
+        stats.worker = ThreadPool::current_index();
+        ++stats.frames;
+        if (stats.budget != 0 && stats.last > stats.budget)
+            ++stats.overruns;
+    }
+
+    template<typename WorldType>
+    inline void Runtime<WorldType>::rebalance() noexcept
+    {
+        // Время миров от кадра к кадру меняется мало, порядок почти отсортирован,
+        // и вставками он обновляется за проход.
+        for (size_type i = 1; i < order.size(); ++i)
+        {
+            const size_type index = order[i];
+            const uint64_t time = slots[index]->stats.last;
+            size_type j = i;
+            for (; j > 0 && slots[order[j - 1]]->stats.last < time; --j)
+                order[j] = order[j - 1];
+            order[j] = index;
+        }
+    }
+}
+
+#endif //CORSAC_ECS_RUNTIME_H
@@ -0,0 +1,274 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_SCHEDULER_H
+#define CORSAC_ECS_SCHEDULER_H
+
+#include "Corsac/component.h"
+#include "Corsac/group.h"
+#include "Corsac/thread_pool.h"
+#include "Corsac/vector.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace corsac
+{
+    namespace internal
+    {
+        // Адреса хранилищ Components для графа конфликтов, группы раскрыты в участников.
+        template<auto&... Components>
+        inline const corsac::vector<const void*>& conflict_set()
+        {
+            static const corsac::vector<const void*> storages = [] {
+                corsac::vector<const void*> out;
+                (conflict_storages(Components, out), ...);
+                return out;
+            }();
+            return storages;
+        }
+    }
+
+    /**
+     * Reads / Writes
+     *
+     * Наборы компонентов, которые система читает и изменяет.
+     * Компоненты задаются ссылками, как в Group и View. Группа означает и всех своих
+     * участников: Writes<Unit> конфликтует с Reads<Position>, если Position входит в Unit.
+     *
+     * scheduler.add<Reads<Direction, Speed>, Writes<Position>>(Move);
+     */
+    template<auto&... Components>
+    struct Reads
+    {
+        static const corsac::vector<const void*>& storages()
+        {
+            return internal::conflict_set<Components...>();
+        }
+    };
+
+    template<auto&... Components>
+    struct Writes
+    {
+        static const corsac::vector<const void*>& storages()
+        {
+            return internal::conflict_set<Components...>();
+        }
+    };
+
+    enum ScheduleMode
+    {
+        PARALLEL,       // Готовые системы запускаются сразу, как только завершены все конфликтующие предшественники.
+        DETERMINISTIC   // Системы выполняются по одной в порядке добавления в вызывающем потоке.
+    };
+
+    /**
+     * Scheduler
+     *
+     * Граф конфликтов систем. Система B зависит от добавленной раньше системы A,
+     * если одна из них пишет компонент, который другая читает или пишет.
+     * Независимые системы выполняются одновременно на потоках пула.
+     */
+    class Scheduler
+    {
+        using function_type = std::function<void()>;
+
+        struct node
+        {
+            function_type                      function;
+            const corsac::vector<const void*>* reads;
+            const corsac::vector<const void*>* writes;
+            corsac::vector<size_t>             dependents;
+            size_t                             dependencies = 0;
+        };
+
+        // Состояние одного run(): живет, пока его держат задачи пула, а не стек run().
+        // ready и done меняются под mutex, готовые системы забирает первый свободный:
+        // поток пула или сам вызывающий run().
+        struct run_state
+        {
+            std::unique_ptr<std::atomic<size_t>[]> pending;
+            corsac::vector<size_t>                 ready;
+            size_t                                 done  = 0;
+            size_t                                 count = 0;
+            std::mutex                             mutex;
+            std::condition_variable                changed;
+        };
+
+    public:
+        using size_type = size_t;
+
+    protected:
+        corsac::vector<node> nodes;
+
+    public:
+        Scheduler() noexcept = default;
+
+        template<typename R, typename W, typename F>
+        size_type add(F&& f);
+
+        void run(ThreadPool& pool, ScheduleMode mode = PARALLEL);
+        void run();
+
+        // Система index должна дождаться завершения системы dependency.
+        [[nodiscard]] bool depends(size_type index, size_type dependency) const noexcept;
+
+        [[nodiscard]] size_type size() const noexcept;
+        void clear() noexcept;
+
+    private:
+        void launch(ThreadPool& pool, const std::shared_ptr<run_state>& state, size_type index);
+        void execute(ThreadPool& pool, const std::shared_ptr<run_state>& state, size_type index);
+
+        static bool intersects(const corsac::vector<const void*>& lhs, const corsac::vector<const void*>& rhs) noexcept;
+        static bool conflicts(const node& lhs, const node& rhs) noexcept;
+    };
+
+    template<typename R, typename W, typename F>
+    inline Scheduler::size_type Scheduler::add(F&& f)
+    {
+        node n;
+        n.function   = function_type(corsac::forward<F>(f));
+        n.reads      = &R::storages();
+        n.writes     = &W::storages();
+
+        const size_type index = nodes.size();
+        for (size_type i = 0; i < index; ++i)
+        {
+            if (conflicts(nodes[i], n))
+            {
+                nodes[i].dependents.push_back(index);
+                ++n.dependencies;
+            }
+        }
+        nodes.push_back(corsac::move(n));
+        return index;
+    }
+
+    inline void Scheduler::run(ThreadPool& pool, ScheduleMode mode)
+    {
+        if (mode == DETERMINISTIC || nodes.size() < 2)
+        {
+            run();
+            return;
+        }
+
+        auto state = std::make_shared<run_state>();
+        state->count = nodes.size();
+        state->pending.reset(new std::atomic<size_t>[nodes.size()]);
+        for (size_type i = 0; i < nodes.size(); ++i)
+            state->pending[i] = nodes[i].dependencies;
+
+        for (size_type i = 0; i < nodes.size(); ++i)
+        {
+            if (nodes[i].dependencies == 0)
+                launch(pool, state, i);
+        }
+
+        // Вызывающий поток не только ждет, но и выполняет готовые системы:
+        // run() из задачи того же пула не ждет освобождения своего же потока.
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (state->done != state->count)
+        {
+            if (state->ready.empty())
+            {
+                state->changed.wait(lock);
+                continue;
+            }
+            const size_type index = state->ready.back();
+            state->ready.pop_back();
+            lock.unlock();
+            execute(pool, state, index);
+            lock.lock();
+        }
+    }
+
+    inline void Scheduler::launch(ThreadPool& pool, const std::shared_ptr<run_state>& state, size_type index)
+    {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->ready.push_back(index);
+        }
+        state->changed.notify_one();
+        // На каждую готовую систему одна задача пула. Если систему уже забрал вызывающий поток,
+        // задача ничего не делает и не трогает this: run() мог уже вернуться.
+        pool.submit([this, &pool, state]
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->ready.empty())
+                return;
+            const size_type next = state->ready.back();
+            state->ready.pop_back();
+            lock.unlock();
+            execute(pool, state, next);
+        });
+    }
+
+    inline void Scheduler::execute(ThreadPool& pool, const std::shared_ptr<run_state>& state, size_type index)
+    {
+        // Каждая завершенная система освобождает зависимые, у которых не осталось ожиданий.
+        nodes[index].function();
+        for (size_type dependent : nodes[index].dependents)
+        {
+            if (--state->pending[dependent] == 0)
+                launch(pool, state, dependent);
+        }
+        // После последнего завершения run() может вернуться: дальше только state, без this и nodes.
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (++state->done == state->count)
+            state->changed.notify_all();
+    }
+
+    inline void Scheduler::run()
+    {
+        for (auto& n : nodes)
+            n.function();
+    }
+
+    inline bool Scheduler::depends(size_type index, size_type dependency) const noexcept
+    {
+        const auto& dependents = nodes[dependency].dependents;
+        for (size_type dependent : dependents)
+        {
+            if (dependent == index)
+                return true;
+        }
+        return false;
+    }
+
+    inline Scheduler::size_type Scheduler::size() const noexcept
+    {
+        return nodes.size();
+    }
+
+    inline void Scheduler::clear() noexcept
+    {
+        nodes.clear();
+    }
+
+    inline bool Scheduler::intersects(const corsac::vector<const void*>& lhs, const corsac::vector<const void*>& rhs) noexcept
+    {
+        for (const void* l : lhs)
+        {
+            for (const void* r : rhs)
+            {
+                if (l == r)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool Scheduler::conflicts(const node& lhs, const node& rhs) noexcept
+    {
+        return intersects(*lhs.writes, *rhs.writes)
+            || intersects(*lhs.writes, *rhs.reads)
+            || intersects(*lhs.reads, *rhs.writes);
+    }
+}
+
+#endif //CORSAC_ECS_SCHEDULER_H
@@ -0,0 +1,310 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_SIMD_H
+#define CORSAC_ECS_SIMD_H
+
+#include "Corsac/type_traits.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(CORSAC_ECS_SIMD_DISABLE) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define CORSAC_ECS_SIMD_X86 1
+    #include <immintrin.h>
+    #define CORSAC_ECS_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define CORSAC_ECS_SIMD_X86 0
+#endif
+
+namespace corsac
+{
+    /**
+     * SimdLevel
+     *
+     * Набор инструкций колоночных ядер, выбирается при первом вызове по CPUID:
+     *      SIMD_SCALAR - обычный цикл, на любой платформе.
+     *      SIMD_SSE42  - 128 бит.
+     *      SIMD_AVX2   - 256 бит.
+     */
+    enum SimdLevel
+    {
+        SIMD_SCALAR,
+        SIMD_SSE42,
+        SIMD_AVX2
+    };
+
+    namespace internal
+    {
+        inline SimdLevel detect_simd_level() noexcept
+        {
+        #if CORSAC_ECS_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return SIMD_AVX2;
+            if (__builtin_cpu_supports("sse4.2"))
+                return SIMD_SSE42;
+        #endif
+            return SIMD_SCALAR;
+        }
+
+        inline SimdLevel& simd_level_ref() noexcept
+        {
+            static SimdLevel level = detect_simd_level();
+            return level;
+        }
+
+        /**
+         * simd_scalar
+         *
+         * Ядра по одному элементу. Ими же векторные ядра дорабатывают хвост
+         * n % width, поэтому результат не зависит от выбранного набора инструкций.
+         */
+        struct simd_scalar
+        {
+            template<typename T>
+            static void add(T* dst, const T* a, size_t first, size_t n) noexcept
+            {
+                for (size_t i = first; i < n; ++i)
+                    dst[i] += a[i];
+            }
+
+            template<typename T>
+            static void mul(T* dst, const T* a, size_t first, size_t n) noexcept
+            {
+                for (size_t i = first; i < n; ++i)
+                    dst[i] *= a[i];
+            }
+
+            template<typename T>
+            static void mul_add(T* dst, const T* a, const T* b, size_t first, size_t n) noexcept
+            {
+                for (size_t i = first; i < n; ++i)
+                    dst[i] += a[i] * b[i];
+            }
+
+            template<typename T>
+            static void scale(T* dst, T s, size_t first, size_t n) noexcept
+            {
+                for (size_t i = first; i < n; ++i)
+                    dst[i] *= s;
+            }
+
+            template<typename T>
+            static void fill(T* dst, T s, size_t first, size_t n) noexcept
+            {
+                for (size_t i = first; i < n; ++i)
+                    dst[i] = s;
+            }
+        };
+
+    #if CORSAC_ECS_SIMD_X86
+        // Регистры и операции по наборам инструкций. Ядра ниже общие для всех наборов.
+        template<typename T> struct sse42_ops;
+        template<typename T> struct avx2_ops;
+
+        template<> struct sse42_ops<float>
+        {
+            using reg = __m128;
+            static constexpr size_t width = 4;
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg load(const float* p) noexcept { return _mm_loadu_ps(p); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static void store(float* p, reg x) noexcept { _mm_storeu_ps(p, x); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg set(float s) noexcept { return _mm_set1_ps(s); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg add(reg x, reg y) noexcept { return _mm_add_ps(x, y); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg mul(reg x, reg y) noexcept { return _mm_mul_ps(x, y); }
+        };
+
+        template<> struct sse42_ops<int32_t>
+        {
+            using reg = __m128i;
+            static constexpr size_t width = 4;
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg load(const int32_t* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static void store(int32_t* p, reg x) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg set(int32_t s) noexcept { return _mm_set1_epi32(s); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg add(reg x, reg y) noexcept { return _mm_add_epi32(x, y); }
+            CORSAC_ECS_SIMD_TARGET("sse4.2") static reg mul(reg x, reg y) noexcept { return _mm_mullo_epi32(x, y); }
+        };
+
+        template<> struct avx2_ops<float>
+        {
+            using reg = __m256;
+            static constexpr size_t width = 8;
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static void store(float* p, reg x) noexcept { _mm256_storeu_ps(p, x); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg set(float s) noexcept { return _mm256_set1_ps(s); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg add(reg x, reg y) noexcept { return _mm256_add_ps(x, y); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg mul(reg x, reg y) noexcept { return _mm256_mul_ps(x, y); }
+        };
+
+        template<> struct avx2_ops<int32_t>
+        {
+            using reg = __m256i;
+            static constexpr size_t width = 8;
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg load(const int32_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static void store(int32_t* p, reg x) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg set(int32_t s) noexcept { return _mm256_set1_epi32(s); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg add(reg x, reg y) noexcept { return _mm256_add_epi32(x, y); }
+            CORSAC_ECS_SIMD_TARGET("avx2") static reg mul(reg x, reg y) noexcept { return _mm256_mullo_epi32(x, y); }
+        };
+
+        /**
+         * CORSAC_ECS_SIMD_KERNELS
+         *
+         * Ядра набора ISA над регистрами OPS<T>: векторная часть до последнего полного регистра,
+         * хвост - simd_scalar. Каждое ядро собирается со своим target, поэтому интринсики
+         * встраиваются без -mavx2 для всей программы. Умножение и сложение выполняются
+         * раздельно (без FMA), как в скалярном цикле.
+         */
+        #define CORSAC_ECS_SIMD_KERNELS(ISA, TARGET, OPS)                                                   \
+            template<typename T>                                                                           \
+            CORSAC_ECS_SIMD_TARGET(TARGET) void add_##ISA(T* dst, const T* a, size_t n) noexcept           \
+            {                                                                                              \
+                using V = OPS<T>;                                                                          \
+                size_t i = 0;                                                                              \
+                for (; i + V::width <= n; i += V::width)                                                   \
+                    V::store(dst + i, V::add(V::load(dst + i), V::load(a + i)));                           \
+                simd_scalar::add(dst, a, i, n);                                                            \
+            }                                                                                              \
+            template<typename T>                                                                           \
+            CORSAC_ECS_SIMD_TARGET(TARGET) void mul_##ISA(T* dst, const T* a, size_t n) noexcept           \
+            {                                                                                              \
+                using V = OPS<T>;                                                                          \
+                size_t i = 0;                                                                              \
+                for (; i + V::width <= n; i += V::width)                                                   \
+                    V::store(dst + i, V::mul(V::load(dst + i), V::load(a + i)));                           \
+                simd_scalar::mul(dst, a, i, n);                                                            \
+            }                                                                                              \
+            template<typename T>                                                                           \
+            CORSAC_ECS_SIMD_TARGET(TARGET) void mul_add_##ISA(T* dst, const T* a, const T* b,              \
+                                                              size_t n) noexcept                           \
+            {                                                                                              \
+                using V = OPS<T>;                                                                          \
+                size_t i = 0;                                                                              \
+                for (; i + V::width <= n; i += V::width)                                                   \
+                    V::store(dst + i, V::add(V::load(dst + i), V::mul(V::load(a + i), V::load(b + i))));   \
+                simd_scalar::mul_add(dst, a, b, i, n);                                                     \
+            }                                                                                              \
+            template<typename T>                                                                           \
+            CORSAC_ECS_SIMD_TARGET(TARGET) void scale_##ISA(T* dst, T s, size_t n) noexcept                \
+            {                                                                                              \
+                using V = OPS<T>;                                                                          \
+                const typename V::reg factor = V::set(s);                                                  \
+                size_t i = 0;                                                                              \
+                for (; i + V::width <= n; i += V::width)                                                   \
+                    V::store(dst + i, V::mul(V::load(dst + i), factor));                                   \
+                simd_scalar::scale(dst, s, i, n);                                                          \
+            }                                                                                              \
+            template<typename T>                                                                           \
+            CORSAC_ECS_SIMD_TARGET(TARGET) void fill_##ISA(T* dst, T s, size_t n) noexcept                 \
+            {                                                                                              \
+                using V = OPS<T>;                                                                          \
+                const typename V::reg value = V::set(s);                                                   \
+                size_t i = 0;                                                                              \
+                for (; i + V::width <= n; i += V::width)                                                   \
+                    V::store(dst + i, value);                                                              \
+                simd_scalar::fill(dst, s, i, n);                                                           \
+            }
+
+        CORSAC_ECS_SIMD_KERNELS(sse42, "sse4.2", sse42_ops)
+        CORSAC_ECS_SIMD_KERNELS(avx2, "avx2", avx2_ops)
+
+        #undef CORSAC_ECS_SIMD_KERNELS
+    #endif
+
+        template<typename T>
+        struct is_simd_type
+        {
+            static constexpr bool value = corsac::is_same_v<T, float> || corsac::is_same_v<T, int32_t>;
+        };
+    }
+
+    // Текущий набор инструкций ядер.
+    inline SimdLevel simd_level() noexcept
+    {
+        return internal::simd_level_ref();
+    }
+
+    // Ограничивает набор инструкций ядер, выше поддерживаемого процессором не поднимается.
+    inline void set_simd_level(SimdLevel level) noexcept
+    {
+        const SimdLevel supported = internal::detect_simd_level();
+        internal::simd_level_ref() = level < supported ? level : supported;
+    }
+
+    /**
+     * simd
+     *
+     * Поэлементные ядра над колонками одинаковой длины n, для float и int32_t:
+     *      add(dst, a, n)          - dst[i] += a[i]
+     *      mul(dst, a, n)          - dst[i] *= a[i]
+     *      mul_add(dst, a, b, n)   - dst[i] += a[i] * b[i]
+     *      scale(dst, s, n)        - dst[i] *= s
+     *      fill(dst, s, n)         - dst[i] = s
+     *
+     * Колонки берутся из ComponentSoA::get<I>() и ComponentAoS::data(). Колонки разных
+     * компонентов выровнены по сущностям в префиксе владеющей группы:
+     *
+     * // OwningGroup<Position, Direction, Speed> Unit;
+     * simd::mul_add(Position.get<0>(), Direction.get<0>(), Speed.data(), Unit.size());
+     * simd::mul_add(Position.get<1>(), Direction.get<1>(), Speed.data(), Unit.size());
+     */
+    namespace simd
+    {
+    #if CORSAC_ECS_SIMD_X86
+        #define CORSAC_ECS_SIMD_DISPATCH(NAME, ...)                                 \
+            switch (simd_level())                                                   \
+            {                                                                       \
+                case SIMD_AVX2:  internal::NAME##_avx2(__VA_ARGS__); return;        \
+                case SIMD_SSE42: internal::NAME##_sse42(__VA_ARGS__); return;       \
+                default: break;                                                     \
+            }
+    #else
+        #define CORSAC_ECS_SIMD_DISPATCH(NAME, ...)
+    #endif
+
+        template<typename T>
+        inline void add(T* dst, const T* a, size_t n) noexcept
+        {
+            static_assert(internal::is_simd_type<T>::value, "simd::add - only float and int32_t columns");
+            CORSAC_ECS_SIMD_DISPATCH(add, dst, a, n)
+            internal::simd_scalar::add(dst, a, 0, n);
+        }
+
+        template<typename T>
+        inline void mul(T* dst, const T* a, size_t n) noexcept
+        {
+            static_assert(internal::is_simd_type<T>::value, "simd::mul - only float and int32_t columns");
+            CORSAC_ECS_SIMD_DISPATCH(mul, dst, a, n)
+            internal::simd_scalar::mul(dst, a, 0, n);
+        }
+
+        template<typename T>
+        inline void mul_add(T* dst, const T* a, const T* b, size_t n) noexcept
+        {
+            static_assert(internal::is_simd_type<T>::value, "simd::mul_add - only float and int32_t columns");
+            CORSAC_ECS_SIMD_DISPATCH(mul_add, dst, a, b, n)
+            internal::simd_scalar::mul_add(dst, a, b, 0, n);
+        }
+
+        template<typename T>
+        inline void scale(T* dst, T s, size_t n) noexcept
+        {
+            static_assert(internal::is_simd_type<T>::value, "simd::scale - only float and int32_t columns");
+            CORSAC_ECS_SIMD_DISPATCH(scale, dst, s, n)
+            internal::simd_scalar::scale(dst, s, 0, n);
+        }
+
+        template<typename T>
+        inline void fill(T* dst, T s, size_t n) noexcept
+        {
+            static_assert(internal::is_simd_type<T>::value, "simd::fill - only float and int32_t columns");
+            CORSAC_ECS_SIMD_DISPATCH(fill, dst, s, n)
+            internal::simd_scalar::fill(dst, s, 0, n);
+        }
+
+        #undef CORSAC_ECS_SIMD_DISPATCH
+    }
+}
+
+#endif //CORSAC_ECS_SIMD_H
@@ -0,0 +1,265 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_SNAPSHOT_H
+#define CORSAC_ECS_SNAPSHOT_H
+
+#include "Corsac/type_traits.h"
+#include "Corsac/vector.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace corsac
+{
+    namespace internal
+    {
+        enum SnapshotBlock : uint16_t
+        {
+            SNAPSHOT_SET,
+            SNAPSHOT_AOS,
+            SNAPSHOT_SOA,
+            SNAPSHOT_ALLOCATOR,
+            SNAPSHOT_DELTA,
+            SNAPSHOT_DELTA_ALLOCATOR,
+            SNAPSHOT_DELTA_REMOVED,
+            SNAPSHOT_DELTA_CHANGES
+        };
+
+        /**
+         * snapshot_header
+         *
+         * Заголовок блока снимка. stride - байт на элемент блока (ID и значения всех колонок),
+         * по нему restore проверяет, что блок записан хранилищем той же раскладки.
+         */
+        struct snapshot_header
+        {
+            static constexpr uint32_t magic_value   = 0x504E5343; // "CSNP"
+            static constexpr uint16_t version_value = 1;
+
+            uint32_t magic   = magic_value;
+            uint16_t version = version_value;
+            uint16_t kind    = 0;
+            uint32_t columns = 0;
+            uint32_t stride  = 0;
+            uint64_t count   = 0;
+        };
+    }
+
+    /**
+     * Snapshot
+     *
+     * Двоичный снимок хранилищ: последовательность блоков с заголовком и сырыми массивами
+     * packed и колонок значений. Значения копируются memcpy, поэтому должны быть тривиально
+     * копируемыми, а снимок читается только сборкой с той же раскладкой типов.
+     *
+     * corsac::Snapshot state;
+     * corsac::snapshot<Position, Health, Unit>(state);
+     * state.save("level.bin");
+     * ...
+     * state.load("level.bin");
+     * corsac::restore<Position, Health, Unit>(state);
+     *
+     * Блоки читаются в том же порядке, в котором записаны. Тот же буфер несет дельты
+     * DeltaEncoder (Corsac/delta.h).
+     */
+    class Snapshot
+    {
+    public:
+        using size_type = size_t;
+
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+    protected:
+        corsac::vector<uint8_t> bytes;
+        size_type               cursor = 0;
+
+    public:
+        Snapshot() noexcept = default;
+
+        void write(const void* data, size_type n);
+        void write_header(internal::SnapshotBlock kind, size_type count, uint32_t columns, uint32_t stride);
+
+        // Кол-во элементов следующего блока или npos, если блок другого вида или раскладки.
+        // extra - байты блока сверх count * stride.
+        size_type read_header(internal::SnapshotBlock kind, uint32_t columns, uint32_t stride, size_type extra = 0);
+
+        // Читает n байт, наличие которых проверил read_header.
+        void read(void* data, size_type n) noexcept;
+
+        // Целые переменной длины (LEB128) для дельт, read_varint - false при нехватке данных.
+        void write_varint(uint64_t value);
+        bool read_varint(uint64_t& value) noexcept;
+
+        // Чтение без read_header: false, если осталось меньше n байт.
+        bool read_checked(void* data, size_type n) noexcept;
+
+        [[nodiscard]] const uint8_t* data() const noexcept;
+        [[nodiscard]] size_type      size() const noexcept;
+        [[nodiscard]] size_type      remaining() const noexcept;
+
+        void assign(const void* data, size_type n);
+        void reserve(size_type n);
+        void rewind() noexcept;
+        void clear() noexcept;
+
+        bool save(const char* path) const;
+        bool load(const char* path);
+    };
+
+    inline void Snapshot::write(const void* data, size_type n)
+    {
+        if (n == 0)
+            return;
+        const size_type offset = bytes.size();
+        bytes.resize(offset + n);
+        std::memcpy(bytes.data() + offset, data, n);
+    }
+
+    inline void Snapshot::write_header(internal::SnapshotBlock kind, size_type count, uint32_t columns, uint32_t stride)
+    {
+        internal::snapshot_header header;
+        header.kind = kind;
+        header.columns = columns;
+        header.stride = stride;
+        header.count = static_cast<uint64_t>(count);
+        write(&header, sizeof(header));
+    }
+
+    inline Snapshot::size_type
+    Snapshot::read_header(internal::SnapshotBlock kind, uint32_t columns, uint32_t stride, size_type extra)
+    {
+        internal::snapshot_header header;
+        bool valid = remaining() >= sizeof(header);
+        if (valid)
+        {
+            std::memcpy(&header, bytes.data() + cursor, sizeof(header));
+            const size_type rest = remaining() - sizeof(header);
+            valid = header.magic == internal::snapshot_header::magic_value
+                    && header.version == internal::snapshot_header::version_value
+                    && header.kind == kind && header.columns == columns && header.stride == stride
+                    && rest >= extra
+                    && (stride == 0 || header.count <= (rest - extra) / stride);
+        }
+    #if CORSAC_EXCEPTIONS_ENABLED
+        if(CORSAC_UNLIKELY(!valid))
+            throw std::invalid_argument("Snapshot::read_header -- block does not match storage");
+    #elif CORSAC_ASSERT_ENABLED
+        if(CORSAC_UNLIKELY(!valid))
+            CORSAC_FAIL_MSG("Snapshot::read_header -- block does not match storage");
+    #endif
+        if (!valid)
+            return npos;
+        cursor += sizeof(header);
+        return static_cast<size_type>(header.count);
+    }
+
+    inline void Snapshot::read(void* data, size_type n) noexcept
+    {
+        if (n == 0)
+            return;
+        std::memcpy(data, bytes.data() + cursor, n);
+        cursor += n;
+    }
+
+    inline void Snapshot::write_varint(uint64_t value)
+    {
+        uint8_t buffer[10];
+        size_type n = 0;
+        for (; value >= 0x80; value >>= 7)
+            buffer[n++] = static_cast<uint8_t>(value | 0x80);
+        buffer[n++] = static_cast<uint8_t>(value);
+        write(buffer, n);
+    }
+
+    inline bool Snapshot::read_varint(uint64_t& value) noexcept
+    {
+        value = 0;
+        for (size_t shift = 0; shift < 64 && cursor < bytes.size(); shift += 7)
+        {
+            const uint8_t byte = bytes[cursor++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    inline bool Snapshot::read_checked(void* data, size_type n) noexcept
+    {
+        if (remaining() < n)
+            return false;
+        read(data, n);
+        return true;
+    }
+
+    inline const uint8_t* Snapshot::data() const noexcept
+    {
+        return bytes.data();
+    }
+
+    inline Snapshot::size_type Snapshot::size() const noexcept
+    {
+        return bytes.size();
+    }
+
+    inline Snapshot::size_type Snapshot::remaining() const noexcept
+    {
+        return bytes.size() - cursor;
+    }
+
+    inline void Snapshot::assign(const void* data, size_type n)
+    {
+        bytes.clear();
+        cursor = 0;
+        write(data, n);
+    }
+
+    inline void Snapshot::reserve(size_type n)
+    {
+        bytes.reserve(n);
+    }
+
+    inline void Snapshot::rewind() noexcept
+    {
+        cursor = 0;
+    }
+
+    inline void Snapshot::clear() noexcept
+    {
+        bytes.clear();
+        cursor = 0;
+    }
+
+    inline bool Snapshot::save(const char* path) const
+    {
+        std::FILE* file = std::fopen(path, "wb");
+        if (!file)
+            return false;
+        const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        return std::fclose(file) == 0 && written;
+    }
+
+    inline bool Snapshot::load(const char* path)
+    {
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file)
+            return false;
+        bool loaded = std::fseek(file, 0, SEEK_END) == 0;
+        const long length = loaded ? std::ftell(file) : -1;
+        loaded = length >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+        if (loaded)
+        {
+            bytes.resize(static_cast<size_type>(length));
+            cursor = 0;
+            loaded = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        }
+        std::fclose(file);
+        if (!loaded)
+            clear();
+        return loaded;
+    }
+}
+
+#endif //CORSAC_ECS_SNAPSHOT_H
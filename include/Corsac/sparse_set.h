@@ -10,19 +10,429 @@
 #include "Corsac/fixed_vector.h"
 #include "Corsac/tuple_vector.h"
 #include "Corsac/fixed_tuple_vector.h"
+#include "Corsac/algorithm.h"
+#include "Corsac/entity.h"
+#include "Corsac/registry.h"
+#include "Corsac/mapped_vector.h"
+#include "Corsac/memory.h"
+#include "Corsac/stats.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifndef CORSAC_ECS_SPARSE_PAGE_SIZE
+    #define CORSAC_ECS_SPARSE_PAGE_SIZE 4096
+#endif
 
 namespace corsac
 {
-    template<typename T, size_t nodeCount = 0, bool bEnableOverflow = true>
+    namespace internal
+    {
+        /**
+         * sparse_pages
+         *
+         * Разреженный индекс sparse_set, разбитый на страницы по pageSize элементов.
+         * Страницы выделяются по требованию, пустые диапазоны хранятся как nullptr,
+         * поэтому память растет вместе с кол-вом живых сущностей, а не с максимальным ID.
+         * Адресуется индексной частью ID (entity_traits), версия на позицию не влияет.
+         * Таблица страниц и сами страницы берутся у Allocator.
+         */
+        template<typename T, size_t pageSize, typename Allocator = default_allocator>
+        class sparse_pages
+        {
+            static_assert(pageSize != 0 && (pageSize & (pageSize - 1)) == 0,
+                          "sparse_pages<pageSize> - page size must be a power of two");
+
+            using page_table = corsac::vector<T*, Allocator>;
+
+        public:
+            using size_type = typename page_table::size_type;
+
+            static constexpr T null = static_cast<T>(~T(0));
+
+        protected:
+            page_table pages;
+
+        public:
+            sparse_pages() noexcept = default;
+            sparse_pages(const sparse_pages& x);
+            sparse_pages(sparse_pages&& x) noexcept;
+            ~sparse_pages();
+
+            sparse_pages& operator=(const sparse_pages& x);
+            sparse_pages& operator=(sparse_pages&& x) noexcept;
+
+            [[nodiscard]] bool contains(const T& value) const noexcept;
+
+            T&       operator[](const T& value) noexcept;
+            const T& operator[](const T& value) const noexcept;
+
+            T& assure(const T& value);
+
+            void resize(size_type n);
+            void reserve(size_type n);
+            void set_capacity(size_type n = page_table::npos);
+            void shrink_to_fit();
+            void release_unused(const T* first, const T* last);
+            void clear() noexcept;
+
+            // Забывает страницы без освобождения, их память возвращает ресурс аллокатора.
+            void reset_lose_memory() noexcept;
+
+            [[nodiscard]] size_type size() const noexcept;
+            [[nodiscard]] size_type page_count() const noexcept;
+
+            // Байты выделенных страниц и таблицы страниц.
+            [[nodiscard]] size_t reserved_bytes() const noexcept;
+
+        private:
+            static constexpr size_type page_of(const T& value) noexcept;
+            static constexpr size_type offset_of(const T& value) noexcept;
+            static constexpr size_type pages_for(size_type n) noexcept;
+
+            T*   allocate_page();
+            void free_page(T* page) noexcept;
+        };
+
+        // Копирует n значений, тривиально копируемые типы - одним memcpy.
+        template<typename T, typename size_type>
+        inline void copy_values(const T* first, size_type n, T* dest)
+        {
+            if constexpr (corsac::is_trivially_copyable<T>::value)
+                std::memcpy(dest, first, static_cast<size_t>(n) * sizeof(T));
+            else
+                corsac::copy(first, first + n, dest);
+        }
+
+        /**
+         * sort_order, radix_order
+         *
+         * Порядок позиций packed после сортировки: order[i] - позиция, элемент которой
+         * должен встать на место i. sort_order сравнивает позиции через less(lhs, rhs),
+         * radix_order сортирует устойчиво по целому ключу key(pos) побайтовой LSD сортировкой.
+         */
+        template<typename size_type, typename Less>
+        inline corsac::vector<size_type> sort_order(size_type n, Less less)
+        {
+            corsac::vector<size_type> order(n);
+            for (size_type i = 0; i < n; ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), less);
+            return order;
+        }
+
+        template<typename size_type, typename Key>
+        inline corsac::vector<size_type> radix_order(size_type n, Key key)
+        {
+            using key_type  = corsac::decay_t<decltype(key(size_type(0)))>;
+            static_assert(corsac::is_integral_v<key_type>, "radix_order - key must be integral");
+            using radix_type = corsac::make_unsigned_t<key_type>;
+
+            // Знаковые ключи сдвигаются в беззнаковый порядок инверсией старшего бита.
+            constexpr radix_type bias = corsac::is_signed_v<key_type>
+                    ? static_cast<radix_type>(radix_type(1) << (sizeof(radix_type) * 8 - 1)) : radix_type(0);
+
+            corsac::vector<size_type>  order(n);
+            corsac::vector<size_type>  orderBuffer(n);
+            corsac::vector<radix_type> keys(n);
+            corsac::vector<radix_type> keyBuffer(n);
+            for (size_type i = 0; i < n; ++i)
+            {
+                order[i] = i;
+                keys[i] = static_cast<radix_type>(static_cast<radix_type>(key(i)) ^ bias);
+            }
+
+            for (size_t shift = 0; shift < sizeof(radix_type) * 8; shift += 8)
+            {
+                size_type count[257] = {};
+                for (size_type i = 0; i < n; ++i)
+                    ++count[((keys[i] >> shift) & 0xFF) + 1];
+                // Все ключи в одной корзине - проход ничего не меняет.
+                if (n == 0 || count[((keys[0] >> shift) & 0xFF) + 1] == n)
+                    continue;
+                for (size_t b = 1; b < 257; ++b)
+                    count[b] += count[b - 1];
+                for (size_type i = 0; i < n; ++i)
+                {
+                    const size_type to = count[(keys[i] >> shift) & 0xFF]++;
+                    orderBuffer[to] = order[i];
+                    keyBuffer[to] = keys[i];
+                }
+                order.swap(orderBuffer);
+                keys.swap(keyBuffer);
+            }
+            return order;
+        }
+
+        // Переставляет элементы хранилища по order обходом циклов через storage.swap_at.
+        template<typename Storage, typename size_type>
+        inline void permute(Storage& storage, corsac::vector<size_type>& order)
+        {
+            for (size_type i = 0; i < order.size(); ++i)
+            {
+                size_type current = i;
+                size_type next = order[current];
+                while (next != i)
+                {
+                    storage.swap_at(current, next);
+                    order[current] = current;
+                    current = next;
+                    next = order[current];
+                }
+                order[current] = current;
+            }
+        }
+
+        // Сущности storage, которые есть в other, встают в начало packed в порядке other.
+        template<typename Storage, typename Other>
+        inline void sort_as(Storage& storage, const Other& other)
+        {
+            size_t pos = 0;
+            const auto* first = other.entities();
+            const auto* last = first + other.size();
+            for (; first != last; ++first)
+            {
+                if (storage.has(*first))
+                {
+                    const size_t from = storage.index(*first);
+                    if (from != pos)
+                        storage.swap_at(pos, from);
+                    ++pos;
+                }
+            }
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline sparse_pages<T, pageSize, Allocator>::sparse_pages(const sparse_pages& x)
+            : pages(x.pages.size(), nullptr)
+        {
+            for (size_type i = 0; i < x.pages.size(); ++i)
+            {
+                if (x.pages[i])
+                {
+                    pages[i] = allocate_page();
+                    corsac::copy(x.pages[i], x.pages[i] + pageSize, pages[i]);
+                }
+            }
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline sparse_pages<T, pageSize, Allocator>::sparse_pages(sparse_pages&& x) noexcept
+            : pages(corsac::move(x.pages))
+        {
+            x.pages.clear();
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline sparse_pages<T, pageSize, Allocator>::~sparse_pages()
+        {
+            clear();
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline sparse_pages<T, pageSize, Allocator>& sparse_pages<T, pageSize, Allocator>::operator=(const sparse_pages& x)
+        {
+            if (this != &x)
+            {
+                sparse_pages tmp(x);
+                *this = corsac::move(tmp);
+            }
+            return *this;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline sparse_pages<T, pageSize, Allocator>& sparse_pages<T, pageSize, Allocator>::operator=(sparse_pages&& x) noexcept
+        {
+            if (this != &x)
+            {
+                clear();
+                pages = corsac::move(x.pages);
+                x.pages.clear();
+            }
+            return *this;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline bool sparse_pages<T, pageSize, Allocator>::contains(const T& value) const noexcept
+        {
+            const size_type page = page_of(value);
+            return page < pages.size() && pages[page] != nullptr;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline T& sparse_pages<T, pageSize, Allocator>::operator[](const T& value) noexcept
+        {
+            return pages[page_of(value)][offset_of(value)];
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline const T& sparse_pages<T, pageSize, Allocator>::operator[](const T& value) const noexcept
+        {
+            return pages[page_of(value)][offset_of(value)];
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline T& sparse_pages<T, pageSize, Allocator>::assure(const T& value)
+        {
+            const size_type page = page_of(value);
+            if (page >= pages.size())
+                pages.resize(page + 1, nullptr);
+            if (!pages[page])
+                pages[page] = allocate_page();
+            return pages[page][offset_of(value)];
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::resize(size_type n)
+        {
+            const size_type count = pages_for(n);
+            for (size_type i = count; i < pages.size(); ++i)
+                free_page(pages[i]);
+            pages.resize(count, nullptr);
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::reserve(size_type n)
+        {
+            pages.reserve(pages_for(n));
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::set_capacity(size_type n)
+        {
+            if (n == page_table::npos)
+                pages.set_capacity();
+            else
+            {
+                resize(corsac::min(n, size()));
+                pages.set_capacity(pages_for(n));
+            }
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::shrink_to_fit()
+        {
+            size_type count = pages.size();
+            while (count > 0 && !pages[count - 1])
+                --count;
+            pages.resize(count);
+            pages.shrink_to_fit();
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::release_unused(const T* first, const T* last)
+        {
+            corsac::vector<uint8_t> used(pages.size(), 0);
+            for (; first != last; ++first)
+                used[page_of(*first)] = 1;
+            for (size_type i = 0; i < pages.size(); ++i)
+            {
+                if (!used[i] && pages[i])
+                {
+                    free_page(pages[i]);
+                    pages[i] = nullptr;
+                }
+            }
+            shrink_to_fit();
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::clear() noexcept
+        {
+            for (T* page : pages)
+                free_page(page);
+            pages.clear();
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::reset_lose_memory() noexcept
+        {
+            pages.reset_lose_memory();
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline typename sparse_pages<T, pageSize, Allocator>::size_type
+        sparse_pages<T, pageSize, Allocator>::size() const noexcept
+        {
+            return pages.size() * pageSize;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline typename sparse_pages<T, pageSize, Allocator>::size_type
+        sparse_pages<T, pageSize, Allocator>::page_count() const noexcept
+        {
+            size_type count = 0;
+            for (const T* page : pages)
+                count += page != nullptr;
+            return count;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline size_t sparse_pages<T, pageSize, Allocator>::reserved_bytes() const noexcept
+        {
+            return static_cast<size_t>(page_count()) * pageSize * sizeof(T) + static_cast<size_t>(pages.capacity()) * sizeof(T*);
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        constexpr typename sparse_pages<T, pageSize, Allocator>::size_type
+        sparse_pages<T, pageSize, Allocator>::page_of(const T& value) noexcept
+        {
+            return static_cast<size_type>(entity_traits<T>::index(value)) / pageSize;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        constexpr typename sparse_pages<T, pageSize, Allocator>::size_type
+        sparse_pages<T, pageSize, Allocator>::offset_of(const T& value) noexcept
+        {
+            return static_cast<size_type>(entity_traits<T>::index(value)) & (pageSize - 1);
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        constexpr typename sparse_pages<T, pageSize, Allocator>::size_type
+        sparse_pages<T, pageSize, Allocator>::pages_for(size_type n) noexcept
+        {
+            return (n + pageSize - 1) / pageSize;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline T* sparse_pages<T, pageSize, Allocator>::allocate_page()
+        {
+            T* page = static_cast<T*>(pages.get_allocator().allocate(pageSize * sizeof(T), alignof(T), 0));
+        #if CORSAC_EXCEPTIONS_ENABLED
+            if(CORSAC_UNLIKELY(!page))
+                throw std::bad_alloc();
+        #elif CORSAC_ASSERT_ENABLED
+            if(CORSAC_UNLIKELY(!page))
+                CORSAC_FAIL_MSG("sparse_pages::assure -- out of memory");
+        #endif
+            corsac::fill(page, page + pageSize, null);
+            return page;
+        }
+
+        template<typename T, size_t pageSize, typename Allocator>
+        inline void sparse_pages<T, pageSize, Allocator>::free_page(T* page) noexcept
+        {
+            if (page)
+                pages.get_allocator().deallocate(page, pageSize * sizeof(T));
+        }
+    }
+
+    template<typename T, size_t nodeCount = 0, bool bEnableOverflow = true,
+             size_t pageSize = CORSAC_ECS_SPARSE_PAGE_SIZE, bool bMapped = false,
+             typename Allocator = internal::default_allocator>
     class sparse_set
     {
         static_assert(corsac::is_unsigned_v<T>,
                       "sparse_set can only store integers numbers");
 
         using base_type = corsac::conditional_t<
-                nodeCount == 0,
-                corsac::vector<T>,
-                corsac::fixed_vector<T, nodeCount, bEnableOverflow>
+                bMapped,
+                internal::mapped_vector<T>,
+                corsac::conditional_t<
+                        nodeCount == 0,
+                        corsac::vector<T, Allocator>,
+                        corsac::fixed_vector<T, nodeCount, bEnableOverflow, Allocator>
+                >
         >;
 
         // Base types
@@ -41,9 +451,15 @@ namespace corsac
     public:
         using size_type = typename base_type::size_type;
 
+        using sparse_type = internal::sparse_pages<T, pageSize, Allocator>;
+
     protected:
         base_type packed;
-        base_type sparse;
+        sparse_type sparse;
+        internal::registry_entry entry;
+    #if CORSAC_ECS_STATS
+        internal::storage_stats stats;
+    #endif
 
     public:
         sparse_set() noexcept;
@@ -89,14 +505,68 @@ namespace corsac
         [[nodiscard]] bool has(const_reference value) const;
         [[nodiscard]] bool has(reference& value) const;
 
+        // Позиция значения в packed, значение должно быть в наборе.
+        [[nodiscard]] size_type index(const_reference value) const;
+
+        const_pointer entities() const noexcept;
+
         void add(const_reference value) noexcept;
         void add(reference& value) noexcept;
 
+        // Добавляет n значений с одним резервированием packed и sparse, возвращает кол-во новых.
+        size_type add_n(const_pointer first, size_type n);
+
         void remove(const_reference value) noexcept;
         void remove(reference& value) noexcept;
 
+        // Бит хранилища в реестре сигнатур или internal::registry_npos.
+        [[nodiscard]] size_t signature_bit() const noexcept;
+        // Ранг хранилища в реестре: 0 у компонента, у группы больше, чем у ее участников.
+        [[nodiscard]] size_t registry_rank() const noexcept;
+
+        // Память packed и sparse (Corsac/memory.h), max_id ищется проходом по packed.
+        [[nodiscard]] virtual MemoryUsage memory_usage() const noexcept;
+
+    #if CORSAC_ECS_STATS
+        // Счетчики хранилища для dump_stats (Corsac/stats.h).
+        internal::storage_stats& statistics() noexcept { return stats; }
+    #endif
+
+        // Меняет местами элементы packed в позициях lhs и rhs, sparse исправляется.
+        void swap_at(size_type lhs, size_type rhs) noexcept;
+
+        // Сортирует packed, compare(lhs, rhs) сравнивает значения.
+        template<typename Compare>
+        void sort(Compare compare);
+
+        // Устойчивая поразрядная сортировка по целому ключу key(value).
+        template<typename Key>
+        void sort_by_key(Key key);
+
+        // Общие с other значения встают в начало packed в порядке other.
+        template<typename Other>
+        void sort_as(const Other& other);
+
         void clear() noexcept;
 
+        // Снимок packed одним блоком. restore заменяет содержимое снимком и перестраивает
+        // sparse за один проход, false - блок записан хранилищем другого вида.
+        void snapshot(Snapshot& out) const;
+        bool restore(Snapshot& in);
+
+        // only mapped sparse_set
+        // Отображает packed в файл path, sparse перестраивается по его содержимому.
+        bool open(const char* path);
+        void sync() noexcept;
+
+        // open(path) примет файл, файл не меняется (internal::mapped_vector::accepts).
+        static bool accepts(const char* path);
+
+        // Переносит packed обратно в анонимную память, файл остается с последним состоянием.
+        void close();
+
+        // Забывает память packed и sparse без освобождения: сцена на ArenaAllocator или
+        // PoolAllocator сбрасывается вместе с release() ресурса (Corsac/memory.h).
         virtual void reset_lose_memory() noexcept;
 
         // only fixed sparse_set
@@ -104,75 +574,84 @@ namespace corsac
         [[nodiscard]] bool full() const;
         [[nodiscard]] bool has_overflowed() const;
         [[nodiscard]] bool can_overflow() const;
+
+    protected:
+        void write_packed(Snapshot& out) const;
+        // Заменяет packed n ID из снимка, старые ID снимаются с sparse без освобождения страниц.
+        void read_packed(Snapshot& in, size_type n);
+        // То же для n ID из памяти: возврат к снимку packed после неудачного open().
+        void assign_packed(const T* first, size_type n);
+        // Перестраивает sparse и биты реестра по первым n ID packed, остальные отбрасываются.
+        void rebuild_sparse(size_type n);
     };
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    sparse_set<T, nodeCount, bEnableOverflow>::sparse_set() noexcept = default;
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::sparse_set() noexcept = default;
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    sparse_set<T, nodeCount, bEnableOverflow>::sparse_set(size_type n) noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::sparse_set(size_type n) noexcept
             : packed(n), sparse()
     {}
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::begin() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::begin() noexcept
     {
         return packed.mpBegin;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::begin() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::begin() const noexcept
     {
         return packed.mpBegin;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::end() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::end() noexcept
     {
         return packed.mpEnd;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::end() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::end() const noexcept
     {
         return packed.mpEnd;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::reverse_iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::rbegin() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reverse_iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::rbegin() noexcept
     {
         return reverse_iterator(packed.mpEnd);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_reverse_iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::rbegin() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_reverse_iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::rbegin() const noexcept
     {
         return const_reverse_iterator(packed.mpEnd);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::reverse_iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::rend() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reverse_iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::rend() noexcept
     {
         return reverse_iterator(packed.mpBegin);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_reverse_iterator
-    sparse_set<T, nodeCount, bEnableOverflow>::rend() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_reverse_iterator
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::rend() const noexcept
     {
         return const_reverse_iterator(packed.mpBegin);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::reference
-    sparse_set<T, nodeCount, bEnableOverflow>::front()
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::front()
     {
     #if CORSAC_ASSERT_ENABLED && CORSAC_EMPTY_REFERENCE_ASSERT_ENABLED
         // Мы не разрешаем пользователю ссылаться на пустой контейнер.
@@ -184,9 +663,9 @@ namespace corsac
         return packed.front();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_reference
-    sparse_set<T, nodeCount, bEnableOverflow>::front() const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::front() const
     {
     #if CORSAC_ASSERT_ENABLED && CORSAC_EMPTY_REFERENCE_ASSERT_ENABLED
         // Мы не разрешаем пользователю ссылаться на пустой контейнер.
@@ -198,9 +677,9 @@ namespace corsac
         return packed.front();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::reference
-    sparse_set<T, nodeCount, bEnableOverflow>::back()
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::back()
     {
     #if CORSAC_ASSERT_ENABLED && CORSAC_EMPTY_REFERENCE_ASSERT_ENABLED
         // Мы не разрешаем пользователю ссылаться на пустой контейнер.
@@ -212,9 +691,9 @@ namespace corsac
         return packed.back();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_reference
-    sparse_set<T, nodeCount, bEnableOverflow>::back() const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::back() const
     {
     #if CORSAC_ASSERT_ENABLED && CORSAC_EMPTY_REFERENCE_ASSERT_ENABLED
         // Мы не разрешаем пользователю ссылаться на пустой контейнер.
@@ -226,23 +705,23 @@ namespace corsac
         return packed.back();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::reference
-    sparse_set<T, nodeCount, bEnableOverflow>::at(size_type n)
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::at(size_type n)
     {
         return n < packed.size() ? packed[n] : nullptr;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_reference
-    sparse_set<T, nodeCount, bEnableOverflow>::at(size_type n) const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::at(size_type n) const
     {
         return n < packed.size() ? packed[n] : nullptr;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::reference
-    sparse_set<T, nodeCount, bEnableOverflow>::operator[](size_type n)
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::operator[](size_type n)
     {
     #if CORSAC_EXCEPTIONS_ENABLED
         if(CORSAC_UNLIKELY(n < packed.size()))
@@ -254,9 +733,9 @@ namespace corsac
         return packed[n];
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_reference
-    sparse_set<T, nodeCount, bEnableOverflow>::operator[](size_type n) const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_reference
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::operator[](size_type n) const
     {
     #if CORSAC_EXCEPTIONS_ENABLED
         if(CORSAC_UNLIKELY(n < packed.size()))
@@ -268,140 +747,340 @@ namespace corsac
         return packed[n];
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::resize(size_type n)
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::resize(size_type n)
     {
         packed.resize(n);
         sparse.resize(n);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::reserve(size_type n)
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reserve(size_type n)
     {
         packed.reserve(n);
         sparse.reserve(n);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::set_capacity(size_type n)
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::set_capacity(size_type n)
     {
         packed.set_capacity(n);
         sparse.set_capacity(n);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::shrink_to_fit()
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::shrink_to_fit()
     {
         packed.shrink_to_fit();
-        sparse.shrink_to_fit();
+        sparse.release_unused(packed.begin(), packed.end());
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::pointer
-    sparse_set<T, nodeCount, bEnableOverflow>::data() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::pointer
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::data() noexcept
     {
         return packed.mpBegin;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::const_pointer
-    sparse_set<T, nodeCount, bEnableOverflow>::data() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_pointer
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::data() const noexcept
     {
         return packed.mpBegin;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline bool sparse_set<T, nodeCount, bEnableOverflow>::empty() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::empty() const noexcept
     {
         return packed.empty();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::size_type
-    sparse_set<T, nodeCount, bEnableOverflow>::size() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::size_type
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::size() const noexcept
     {
         return packed.size();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::size_type
-    sparse_set<T, nodeCount, bEnableOverflow>::capacity() const noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::size_type
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::capacity() const noexcept
     {
         return packed.capacity();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline bool sparse_set<T, nodeCount, bEnableOverflow>::has(const_reference value) const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::has(const_reference value) const
+    {
+        return sparse.contains(value) && sparse[value] < packed.size() && packed[sparse[value]] == value;
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::has(reference& value) const
     {
-        return sparse[value] < packed.size() && packed[sparse[value]] == value;
+        return sparse.contains(value) && sparse[value] < packed.size() && packed[sparse[value]] == value;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline bool sparse_set<T, nodeCount, bEnableOverflow>::has(reference& value) const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::size_type
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::index(const_reference value) const
     {
-        return sparse[value] < packed.size() && packed[sparse[value]] == value;
+        return sparse[value];
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::add(const_reference value) noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::const_pointer
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::entities() const noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        return packed.mpBegin;
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::add(const_reference value) noexcept
+    {
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<T>(packed.size());
+        entry.set(value);
         packed.push_back(value);
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::add(reference& value) noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::add(reference& value) noexcept
     {
-        if (value >= sparse.size())
-            sparse.resize(value * 2);
-        else if (has(value))
+        if (has(value))
             return;
-        sparse[value] = packed.size();
+        sparse.assure(value) = static_cast<T>(packed.size());
+        entry.set(value);
         packed.push_back(corsac::move(value));
+        CORSAC_ECS_STATS_ADD(stats, sparse, packed);
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::remove(const_reference value) noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::size_type
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::add_n(const_pointer first, size_type n)
+    {
+        if (n == 0)
+            return 0;
+        T last = 0;
+        for (size_type i = 0; i < n; ++i)
+            last = corsac::max(last, entity_traits<T>::index(first[i]));
+        sparse.reserve(static_cast<size_type>(last) + 1);
+        packed.reserve(packed.size() + n);
+
+        const size_type count = packed.size();
+        for (size_type i = 0; i < n; ++i)
+        {
+            if (has(first[i]))
+                continue;
+            sparse.assure(first[i]) = static_cast<T>(packed.size());
+            entry.set(first[i]);
+            packed.push_back(first[i]);
+            CORSAC_ECS_STATS_ADD(stats, sparse, packed);
+        }
+        return packed.size() - count;
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::remove(const_reference value) noexcept
     {
         if (has(value))
         {
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(T));
+            entry.reset(value);
             packed[sparse[value]] = packed.back();
             sparse[packed.back()] = sparse[value];
             packed.pop_back();
         }
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::remove(reference& value) noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::remove(reference& value) noexcept
     {
         if (has(value))
         {
+            CORSAC_ECS_STATS_REMOVE(stats, sparse[value] + 1 != packed.size(), sizeof(T));
+            entry.reset(value);
             packed[sparse[value]] = packed.back();
             sparse[packed.back()] = sparse[value];
             packed.pop_back();
         }
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::clear() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::swap_at(size_type lhs, size_type rhs) noexcept
+    {
+        const T left = packed[lhs];
+        const T right = packed[rhs];
+        packed[lhs] = right;
+        packed[rhs] = left;
+        sparse[right] = static_cast<T>(lhs);
+        sparse[left] = static_cast<T>(rhs);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline size_t sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::signature_bit() const noexcept
+    {
+        return entry.bit();
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline size_t sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::registry_rank() const noexcept
+    {
+        return entry.rank();
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline MemoryUsage sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::memory_usage() const noexcept
     {
+        MemoryUsage usage;
+        usage.sparse_used     = static_cast<size_t>(packed.size()) * sizeof(T);
+        usage.sparse_capacity = sparse.reserved_bytes();
+        usage.packed_used     = static_cast<size_t>(packed.size()) * sizeof(T);
+        usage.packed_capacity = static_cast<size_t>(packed.capacity()) * sizeof(T);
+        usage.entities        = static_cast<size_t>(packed.size());
+        for (const T& value : packed)
+            usage.max_id = corsac::max(usage.max_id, static_cast<size_t>(entity_traits<T>::index(value)) + 1);
+        return usage;
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    template<typename Compare>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::sort(Compare compare)
+    {
+        auto order = internal::sort_order(packed.size(), [this, &compare](size_type lhs, size_type rhs) {
+            return compare(packed[lhs], packed[rhs]);
+        });
+        internal::permute(*this, order);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    template<typename Key>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::sort_by_key(Key key)
+    {
+        auto order = internal::radix_order(packed.size(), [this, &key](size_type pos) {
+            return key(packed[pos]);
+        });
+        internal::permute(*this, order);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    template<typename Other>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::sort_as(const Other& other)
+    {
+        internal::sort_as(*this, other);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::clear() noexcept
+    {
+        entry.reset(packed.begin(), packed.end());
         packed.clear();
         sparse.clear();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline void sparse_set<T, nodeCount, bEnableOverflow>::reset_lose_memory() noexcept
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::snapshot(Snapshot& out) const
+    {
+        out.write_header(internal::SNAPSHOT_SET, packed.size(), 0, static_cast<uint32_t>(sizeof(T)));
+        write_packed(out);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::restore(Snapshot& in)
+    {
+        const size_type n = in.read_header(internal::SNAPSHOT_SET, 0, static_cast<uint32_t>(sizeof(T)));
+        if (n == Snapshot::npos)
+            return false;
+        read_packed(in, n);
+        return true;
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::write_packed(Snapshot& out) const
+    {
+        out.write(packed.data(), packed.size() * sizeof(T));
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::read_packed(Snapshot& in, size_type n)
+    {
+        entry.reset(packed.begin(), packed.end());
+        for (const T& value : packed)
+            sparse[value] = sparse_type::null;
+        packed.resize(n);
+        in.read(packed.data(), n * sizeof(T));
+        rebuild_sparse(n);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::assign_packed(const T* first, size_type n)
+    {
+        entry.reset(packed.begin(), packed.end());
+        for (const T& value : packed)
+            sparse[value] = sparse_type::null;
+        packed.resize(n);
+        corsac::copy(first, first + n, packed.begin());
+        rebuild_sparse(n);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::rebuild_sparse(size_type n)
+    {
+        packed.resize(n);
+        for (size_type i = 0; i < n; ++i)
+        {
+            sparse.assure(packed[i]) = static_cast<T>(i);
+            entry.set(packed[i]);
+        }
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::open(const char* path)
+    {
+        static_assert(bMapped, "sparse_set::open -- not mapped");
+        entry.reset(packed.begin(), packed.end());
+        for (const T& value : packed)
+            sparse[value] = sparse_type::null;
+        const bool opened = packed.open(path);
+        rebuild_sparse(packed.size());
+        return opened;
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::sync() noexcept
+    {
+        static_assert(bMapped, "sparse_set::sync -- not mapped");
+        packed.sync();
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::accepts(const char* path)
+    {
+        static_assert(bMapped, "sparse_set::accepts -- not mapped");
+        return base_type::accepts(path);
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::close()
+    {
+        static_assert(bMapped, "sparse_set::close -- not mapped");
+        packed.close();
+    }
+
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline void sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::reset_lose_memory() noexcept
     {
+        // Память забывается, но биты реестра снимаются: has<...>() не должен видеть сброшенные ID.
+        entry.reset(packed.begin(), packed.end());
         packed.reset_lose_memory();
+        sparse.reset_lose_memory();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline typename sparse_set<T, nodeCount, bEnableOverflow>::size_type
-    sparse_set<T, nodeCount, bEnableOverflow>::max_size() const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline typename sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::size_type
+    sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::max_size() const
     {
     #if CORSAC_EXCEPTIONS_ENABLED
         if(CORSAC_UNLIKELY(nodeCount == 0))
@@ -413,8 +1092,8 @@ namespace corsac
         return packed.kMaxSize;
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline bool sparse_set<T, nodeCount, bEnableOverflow>::full() const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::full() const
     {
     #if CORSAC_EXCEPTIONS_ENABLED
         if(CORSAC_UNLIKELY(nodeCount == 0))
@@ -426,8 +1105,8 @@ namespace corsac
         return packed.full();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline bool sparse_set<T, nodeCount, bEnableOverflow>::has_overflowed() const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::has_overflowed() const
     {
     #if CORSAC_EXCEPTIONS_ENABLED
         if(CORSAC_UNLIKELY(nodeCount == 0))
@@ -439,8 +1118,8 @@ namespace corsac
         return packed.has_overflowed();
     }
 
-    template <typename T, size_t nodeCount, bool bEnableOverflow>
-    inline bool sparse_set<T, nodeCount, bEnableOverflow>::can_overflow() const
+    template <typename T, size_t nodeCount, bool bEnableOverflow, size_t pageSize, bool bMapped, typename Allocator>
+    inline bool sparse_set<T, nodeCount, bEnableOverflow, pageSize, bMapped, Allocator>::can_overflow() const
     {
     #if CORSAC_EXCEPTIONS_ENABLED
         if(CORSAC_UNLIKELY(nodeCount == 0))
@@ -0,0 +1,405 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_STATS_H
+#define CORSAC_ECS_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * CORSAC_ECS_STATS
+ *
+ * 1 - хранилища считают добавления, удаления, рост sparse, переразмещения packed и значений
+ * и перемещенные байты, а System и CORSAC_ECS_STATS_SCOPE пишут время циклов в гистограммы.
+ * 0 (по умолчанию) - макросы ниже раскрываются в пустоту, хранилища не содержат счетчиков.
+ */
+#ifndef CORSAC_ECS_STATS
+    #define CORSAC_ECS_STATS 0
+#endif
+
+#define CORSAC_ECS_STATS_JOIN_IMPL(a, b) a##b
+#define CORSAC_ECS_STATS_JOIN(a, b) CORSAC_ECS_STATS_JOIN_IMPL(a, b)
+
+#if CORSAC_ECS_STATS
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+    // Вставка: один счетчик и сравнение емкостей sparse и packed с прошлым разом.
+    #define CORSAC_ECS_STATS_ADD(stats, sparse, packed) \
+        (stats).add((sparse).size(), (packed).capacity(), (packed).size() - 1, sizeof((packed)[0]))
+    // Переразмещение значений, row - байт на сущность во всех колонках.
+    #define CORSAC_ECS_STATS_VALUES(stats, values, row) \
+        (stats).values((values).capacity(), (values).size() - 1, (row))
+    // То же для пакетной вставки: до роста в values было kept строк.
+    #define CORSAC_ECS_STATS_VALUES_N(stats, values, kept, row) \
+        (stats).values((values).capacity(), (kept), (row))
+    // Удаление, moved - последний элемент переехал на место удаленного (swap and pop).
+    #define CORSAC_ECS_STATS_REMOVE(stats, moved, row) \
+        (stats).remove((moved), (row))
+    // Время обхода хранилища до конца области.
+    #define CORSAC_ECS_STATS_ITERATE(storage) \
+        const corsac::internal::stats_timer CORSAC_ECS_STATS_JOIN(corsacStatsTimer, __LINE__)((storage).statistics().iterate)
+    // Время области в гистограмме с именем name.
+    #define CORSAC_ECS_STATS_SCOPE(name) \
+        static corsac::internal::loop_stats CORSAC_ECS_STATS_JOIN(corsacLoopStats, __LINE__)(name); \
+        const corsac::internal::stats_timer CORSAC_ECS_STATS_JOIN(corsacStatsTimer, __LINE__)(CORSAC_ECS_STATS_JOIN(corsacLoopStats, __LINE__).histogram)
+    // Имя хранилища в dump_stats.
+    #define CORSAC_ECS_STATS_NAME(storage, name) \
+        (storage).statistics().set_name(name)
+
+#else
+
+    #define CORSAC_ECS_STATS_ADD(stats, sparse, packed) ((void)0)
+    #define CORSAC_ECS_STATS_VALUES(stats, values, row) ((void)0)
+    #define CORSAC_ECS_STATS_VALUES_N(stats, values, kept, row) ((void)0)
+    #define CORSAC_ECS_STATS_REMOVE(stats, moved, row) ((void)0)
+    #define CORSAC_ECS_STATS_ITERATE(storage) ((void)0)
+    #define CORSAC_ECS_STATS_SCOPE(name) ((void)0)
+    #define CORSAC_ECS_STATS_NAME(storage, name) ((void)0)
+
+#endif
+
+namespace corsac
+{
+#if CORSAC_ECS_STATS
+    namespace internal
+    {
+        /**
+         * stat_counter
+         *
+         * Счетчик с одним писателем - потоком, владеющим хранилищем. Инкремент - relaxed
+         * load и store без lock-префикса, dump_stats читает его из другого потока.
+         */
+        class stat_counter
+        {
+            std::atomic<uint64_t> value{0};
+
+        public:
+            stat_counter() noexcept = default;
+            stat_counter(const stat_counter&) noexcept {}
+            stat_counter& operator=(const stat_counter&) noexcept { return *this; }
+
+            void add(uint64_t n) noexcept
+            {
+                value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] uint64_t load() const noexcept
+            {
+                return value.load(std::memory_order_relaxed);
+            }
+        };
+
+        /**
+         * latency_histogram
+         *
+         * Гистограмма длительностей в наносекундах: корзина i считает значения меньше 2^i.
+         * Писателей может быть несколько (одна система в разных мирах), поэтому fetch_add.
+         */
+        class latency_histogram
+        {
+        public:
+            static constexpr size_t bucket_count = 40;
+
+        protected:
+            std::atomic<uint64_t> buckets[bucket_count] = {};
+            std::atomic<uint64_t> sum{0};
+            std::atomic<uint64_t> count{0};
+
+        public:
+            latency_histogram() noexcept = default;
+            latency_histogram(const latency_histogram&) noexcept {}
+            latency_histogram& operator=(const latency_histogram&) noexcept { return *this; }
+
+            void record(uint64_t ns) noexcept
+            {
+                size_t bucket = 0;
+                while (bucket + 1 < bucket_count && (ns >> bucket) != 0)
+                    ++bucket;
+                buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+                sum.fetch_add(ns, std::memory_order_relaxed);
+                count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] uint64_t bucket(size_t i) const noexcept
+            {
+                return buckets[i].load(std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] uint64_t total() const noexcept
+            {
+                return sum.load(std::memory_order_relaxed);
+            }
+
+            [[nodiscard]] uint64_t samples() const noexcept
+            {
+                return count.load(std::memory_order_relaxed);
+            }
+
+            // Prometheus: name_bucket{label,le="2^i"} нарастающим итогом, name_sum, name_count.
+            void dump(std::FILE* out, const char* name, const char* label) const
+            {
+                size_t last = 0;
+                for (size_t i = 0; i < bucket_count; ++i)
+                {
+                    if (bucket(i) != 0)
+                        last = i;
+                }
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i <= last && samples() != 0; ++i)
+                {
+                    cumulative += bucket(i);
+                    std::fprintf(out, "%s_bucket{%s,le=\"%llu\"} %llu\n", name, label,
+                                 static_cast<unsigned long long>(uint64_t(1) << i),
+                                 static_cast<unsigned long long>(cumulative));
+                }
+                std::fprintf(out, "%s_bucket{%s,le=\"+Inf\"} %llu\n", name, label, static_cast<unsigned long long>(samples()));
+                std::fprintf(out, "%s_sum{%s} %llu\n", name, label, static_cast<unsigned long long>(total()));
+                std::fprintf(out, "%s_count{%s} %llu\n", name, label, static_cast<unsigned long long>(samples()));
+            }
+        };
+
+        class stats_timer
+        {
+            latency_histogram&                    histogram;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            explicit stats_timer(latency_histogram& h) noexcept
+                : histogram(h), start(std::chrono::steady_clock::now())
+            {}
+
+            stats_timer(const stats_timer&) = delete;
+            stats_timer& operator=(const stats_timer&) = delete;
+
+            ~stats_timer()
+            {
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        };
+
+        /**
+         * stats_list
+         *
+         * Живые узлы статистики одного вида для dump_stats. Список не разрушается до конца
+         * процесса: глобальные хранилища снимаются с него в своих деструкторах.
+         */
+        template<typename Node>
+        class stats_list
+        {
+        public:
+            std::mutex mutex;
+            Node*      head = nullptr;
+            size_t     next = 0;
+
+            static stats_list& get() noexcept
+            {
+                static stats_list& instance = *new stats_list();
+                return instance;
+            }
+
+            void link(Node* node) noexcept
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                node->id = next++;
+                node->next = head;
+                if (head)
+                    head->prev = node;
+                head = node;
+            }
+
+            void unlink(Node* node) noexcept
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                if (node->prev)
+                    node->prev->next = node->next;
+                else
+                    head = node->next;
+                if (node->next)
+                    node->next->prev = node->prev;
+            }
+        };
+
+        /**
+         * storage_stats
+         *
+         * Счетчики одного хранилища. Рост sparse и переразмещения замечаются по изменению
+         * размера таблицы страниц и емкостей с прошлой вставки, перемещенные байты - это
+         * старое содержимое при переразмещении и строка, переезжающая при удалении.
+         */
+        class storage_stats
+        {
+            friend class stats_list<storage_stats>;
+
+            storage_stats* prev = nullptr;
+            storage_stats* next = nullptr;
+            size_t         id   = 0;
+            const char*    label = nullptr;
+
+            size_t sparseSize     = 0;
+            size_t packedCapacity = 0;
+            size_t valuesCapacity = 0;
+
+        public:
+            stat_counter      adds;
+            stat_counter      removes;
+            stat_counter      sparse_resizes;
+            stat_counter      reallocations;
+            stat_counter      bytes_moved;
+            latency_histogram iterate;
+
+            storage_stats() noexcept
+            {
+                stats_list<storage_stats>::get().link(this);
+            }
+
+            storage_stats(const storage_stats& x) noexcept
+                : label(x.label)
+            {
+                stats_list<storage_stats>::get().link(this);
+            }
+
+            storage_stats& operator=(const storage_stats&) noexcept { return *this; }
+
+            ~storage_stats()
+            {
+                stats_list<storage_stats>::get().unlink(this);
+            }
+
+            void set_name(const char* name) noexcept { label = name; }
+
+            void add(size_t sparse, size_t capacity, size_t kept, size_t element) noexcept
+            {
+                adds.add(1);
+                if (sparse != sparseSize)
+                {
+                    sparse_resizes.add(1);
+                    sparseSize = sparse;
+                }
+                grow(packedCapacity, capacity, kept, element);
+            }
+
+            void values(size_t capacity, size_t kept, size_t row) noexcept
+            {
+                grow(valuesCapacity, capacity, kept, row);
+            }
+
+            void remove(bool moved, size_t row) noexcept
+            {
+                removes.add(1);
+                if (moved)
+                    bytes_moved.add(row);
+            }
+
+            void dump(std::FILE* out) const
+            {
+                char name[96];
+                if (label)
+                    std::snprintf(name, sizeof(name), "storage=\"%s\"", label);
+                else
+                    std::snprintf(name, sizeof(name), "storage=\"#%zu\"", id);
+                std::fprintf(out, "corsac_ecs_adds_total{%s} %llu\n", name, static_cast<unsigned long long>(adds.load()));
+                std::fprintf(out, "corsac_ecs_removes_total{%s} %llu\n", name, static_cast<unsigned long long>(removes.load()));
+                std::fprintf(out, "corsac_ecs_sparse_resizes_total{%s} %llu\n", name, static_cast<unsigned long long>(sparse_resizes.load()));
+                std::fprintf(out, "corsac_ecs_reallocations_total{%s} %llu\n", name, static_cast<unsigned long long>(reallocations.load()));
+                std::fprintf(out, "corsac_ecs_bytes_moved_total{%s} %llu\n", name, static_cast<unsigned long long>(bytes_moved.load()));
+                if (iterate.samples() != 0)
+                    iterate.dump(out, "corsac_ecs_iterate_ns", name);
+            }
+
+            [[nodiscard]] storage_stats* following() const noexcept { return next; }
+
+        private:
+            // Первая емкость (в том числе встроенная у FIXED и STATIC) переразмещением не считается.
+            void grow(size_t& last, size_t capacity, size_t kept, size_t row) noexcept
+            {
+                if (capacity == last)
+                    return;
+                if (last != 0)
+                {
+                    reallocations.add(1);
+                    bytes_moved.add(static_cast<uint64_t>(kept) * row);
+                }
+                last = capacity;
+            }
+        };
+
+        /**
+         * loop_stats
+         *
+         * Именованная гистограмма CORSAC_ECS_STATS_SCOPE.
+         */
+        class loop_stats
+        {
+            friend class stats_list<loop_stats>;
+
+            loop_stats* prev = nullptr;
+            loop_stats* next = nullptr;
+            size_t      id   = 0;
+            const char* label;
+
+        public:
+            latency_histogram histogram;
+
+            explicit loop_stats(const char* name) noexcept
+                : label(name)
+            {
+                stats_list<loop_stats>::get().link(this);
+            }
+
+            loop_stats(const loop_stats&) = delete;
+            loop_stats& operator=(const loop_stats&) = delete;
+
+            ~loop_stats()
+            {
+                stats_list<loop_stats>::get().unlink(this);
+            }
+
+            void dump(std::FILE* out) const
+            {
+                char name[96];
+                std::snprintf(name, sizeof(name), "loop=\"%s\"", label);
+                histogram.dump(out, "corsac_ecs_loop_ns", name);
+            }
+
+            [[nodiscard]] loop_stats* following() const noexcept { return next; }
+        };
+    }
+#endif
+
+    /**
+     * dump_stats
+     *
+     * Текущие счетчики всех живых хранилищ и гистограммы циклов в текстовом формате
+     * Prometheus. Счетчики нарастающие, вызов ничего не сбрасывает и годится для опроса
+     * раз в секунду из любого потока. Без CORSAC_ECS_STATS ничего не пишет.
+     */
+    inline void dump_stats(std::FILE* out)
+    {
+    #if CORSAC_ECS_STATS
+        {
+            auto& storages = internal::stats_list<internal::storage_stats>::get();
+            const std::lock_guard<std::mutex> lock(storages.mutex);
+            for (const internal::storage_stats* s = storages.head; s; s = s->following())
+                s->dump(out);
+        }
+        {
+            auto& loops = internal::stats_list<internal::loop_stats>::get();
+            const std::lock_guard<std::mutex> lock(loops.mutex);
+            for (const internal::loop_stats* l = loops.head; l; l = l->following())
+                l->dump(out);
+        }
+        std::fflush(out);
+    #else
+        (void)out;
+    #endif
+    }
+}
+
+#endif //CORSAC_ECS_STATS_H
@@ -0,0 +1,92 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_SYSTEM_H
+#define CORSAC_ECS_SYSTEM_H
+
+#include "Corsac/component.h"
+#include "Corsac/group.h"
+#include "Corsac/thread_pool.h"
+#include "Corsac/tuple.h"
+
+#ifndef CORSAC_ECS_SYSTEM_CHUNK
+    #define CORSAC_ECS_SYSTEM_CHUNK 4096
+#endif
+
+namespace corsac
+{
+    namespace internal
+    {
+        /**
+         * system_refs
+         *
+         * Аргументы системы для позиции pos хранилища: сущность и ссылки на колонки.
+         * Компоненты отдают колонки по позиции без обращения к sparse,
+         * группа раскрывается в колонки своих компонентов.
+         */
+        template<typename Storage, typename size_type>
+        inline auto system_refs(Storage& storage, size_type pos)
+        {
+            const EntityType value = storage.entities()[pos];
+            if constexpr (Storage::component_type == GROUP)
+                return corsac::tuple_cat(corsac::tuple<EntityType>(value), storage.get_at(pos));
+            else
+                return corsac::tuple_cat(corsac::tuple<EntityType>(value), component_refs(storage, pos));
+        }
+
+        template<typename Storage, typename F, typename size_type>
+        inline void run_system(Storage& storage, F& f, size_type first, size_type last)
+        {
+            for (; first < last; ++first)
+                corsac::apply(f, system_refs(storage, first));
+        }
+    }
+
+    /**
+     * System
+     *
+     * Вызывает F(ent, колонки...) для каждой сущности группы или компонента.
+     * Колонки SoA компонентов раскрываются в отдельные ссылки:
+     *
+     * inline auto Move = [](auto ent, auto& x, auto& y, auto& dx, auto& dy) { ... };
+     *
+     * corsac::System<Move>(Unit);
+     * corsac::System<Move>(Unit, pool);    // куски по CORSAC_ECS_SYSTEM_CHUNK сущностей на потоках пула
+     *
+     * Добавление и удаление сущностей внутри параллельной системы не допускается.
+     */
+    template<auto& F, typename Storage>
+    inline void System(Storage& storage)
+    {
+        CORSAC_ECS_STATS_ITERATE(storage);
+        internal::run_system(storage, F, size_t(0), storage.size());
+    }
+
+    template<auto& F, typename Storage>
+    inline void System(Storage& storage, ThreadPool& pool, size_t chunk = CORSAC_ECS_SYSTEM_CHUNK)
+    {
+        CORSAC_ECS_STATS_ITERATE(storage);
+        pool.parallel_for(storage.size(), chunk, [&storage](size_t first, size_t last) {
+            internal::run_system(storage, F, first, last);
+        });
+    }
+
+    template<typename Storage, typename Function>
+    inline void System(Storage& storage, Function&& f)
+    {
+        CORSAC_ECS_STATS_ITERATE(storage);
+        internal::run_system(storage, f, size_t(0), storage.size());
+    }
+
+    template<typename Storage, typename Function>
+    inline void System(Storage& storage, ThreadPool& pool, Function&& f, size_t chunk = CORSAC_ECS_SYSTEM_CHUNK)
+    {
+        CORSAC_ECS_STATS_ITERATE(storage);
+        pool.parallel_for(storage.size(), chunk, [&storage, &f](size_t first, size_t last) {
+            internal::run_system(storage, f, first, last);
+        });
+    }
+}
+
+#endif //CORSAC_ECS_SYSTEM_H
@@ -0,0 +1,209 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_THREAD_POOL_H
+#define CORSAC_ECS_THREAD_POOL_H
+
+#include "Corsac/type_traits.h"
+#include "Corsac/vector.h"
+#include "Corsac/algorithm.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace corsac
+{
+    class ThreadPool;
+
+    namespace internal
+    {
+        // Номер потока пула, начиная с 1. Для потоков вне пула - 0.
+        inline size_t& worker_index() noexcept
+        {
+            static thread_local size_t index = 0;
+            return index;
+        }
+
+        // Пул, которому принадлежит поток, nullptr для потоков вне пулов.
+        inline const ThreadPool*& worker_pool() noexcept
+        {
+            static thread_local const ThreadPool* pool = nullptr;
+            return pool;
+        }
+    }
+
+    /**
+     * ThreadPool
+     *
+     * Пул рабочих потоков с общей очередью задач.
+     * parallel_for раздает диапазон кусками по мере освобождения потоков,
+     * вызывающий поток тоже выполняет куски, поэтому вложенные вызовы не блокируют пул.
+     */
+    class ThreadPool
+    {
+        using task_type = std::function<void()>;
+
+    public:
+        using size_type = size_t;
+
+    protected:
+        corsac::vector<std::thread> workers;
+        std::deque<task_type>       tasks;
+        std::mutex                  mutex;
+        std::condition_variable     wake;
+        std::condition_variable     idle;
+        size_type                   active = 0;
+        bool                        stop   = false;
+
+    public:
+        explicit ThreadPool(size_type threads = std::thread::hardware_concurrency());
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void submit(task_type task);
+        void wait();
+
+        // f(first, last) для кусков [0, count) размером не больше chunk, возврат после выполнения всех.
+        template<typename F>
+        void parallel_for(size_type count, size_type chunk, F&& f);
+
+        [[nodiscard]] size_type size() const noexcept;
+
+        // Номер текущего потока: 1..size() в потоках пула, 0 в остальных.
+        // Номер задает пул, владеющий потоком, см. owns_current_thread().
+        static size_type current_index() noexcept;
+
+        // Текущий поток - поток этого пула.
+        [[nodiscard]] bool owns_current_thread() const noexcept;
+
+    private:
+        void run(size_type index);
+    };
+
+    inline ThreadPool::ThreadPool(size_type threads)
+    {
+        threads = corsac::max<size_type>(threads, 1);
+        workers.reserve(threads);
+        for (size_type i = 0; i < threads; ++i)
+            workers.push_back(std::thread(&ThreadPool::run, this, i + 1));
+    }
+
+    inline ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    inline void ThreadPool::submit(task_type task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(corsac::move(task));
+        }
+        wake.notify_one();
+    }
+
+    inline void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this] { return tasks.empty() && active == 0; });
+    }
+
+    template<typename F>
+    inline void ThreadPool::parallel_for(size_type count, size_type chunk, F&& f)
+    {
+        if (count == 0)
+            return;
+        chunk = corsac::max<size_type>(chunk, 1);
+
+        struct batch
+        {
+            std::atomic<size_type>  next{0};
+            std::atomic<size_type>  done{0};
+            size_type               chunks = 0;
+            std::mutex              mutex;
+            std::condition_variable finished;
+        };
+
+        auto state = std::make_shared<batch>();
+        state->chunks = (count + chunk - 1) / chunk;
+
+        // Опоздавший помощник не найдет свободных кусков и не обратится к f.
+        auto work = [state, &f, count, chunk]
+        {
+            for (size_type c = state->next++; c < state->chunks; c = state->next++)
+            {
+                f(c * chunk, corsac::min(count, c * chunk + chunk));
+                if (++state->done == state->chunks)
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        const size_type helpers = corsac::min(workers.size(), state->chunks - 1);
+        for (size_type i = 0; i < helpers; ++i)
+            submit(work);
+        work();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state] { return state->done == state->chunks; });
+    }
+
+    inline ThreadPool::size_type ThreadPool::size() const noexcept
+    {
+        return workers.size();
+    }
+
+    inline ThreadPool::size_type ThreadPool::current_index() noexcept
+    {
+        return internal::worker_index();
+    }
+
+    inline bool ThreadPool::owns_current_thread() const noexcept
+    {
+        return internal::worker_pool() == this;
+    }
+
+    inline void ThreadPool::run(size_type index)
+    {
+        internal::worker_index() = index;
+        internal::worker_pool() = this;
+        for (;;)
+        {
+            task_type task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stop || !tasks.empty(); });
+                if (stop && tasks.empty())
+                    return;
+                task = corsac::move(tasks.front());
+                tasks.pop_front();
+                ++active;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --active;
+                if (tasks.empty() && active == 0)
+                    idle.notify_all();
+            }
+        }
+    }
+}
+
+#endif //CORSAC_ECS_THREAD_POOL_H
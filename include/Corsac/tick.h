@@ -0,0 +1,173 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_TICK_H
+#define CORSAC_ECS_TICK_H
+
+#include "Corsac/algorithm.h"
+#include "Corsac/vector.h"
+#include "Corsac/memory.h"
+
+#include <atomic>
+
+namespace corsac
+{
+    /**
+     * Tick
+     *
+     * Счетчик кадров для учета изменений. Тики начинаются с 1, тик 0 - "без фильтра".
+     *
+     * corsac::Tick last = corsac::advance_tick();
+     * // ... системы пишут в Position ...
+     * View<Position>().changed_since(last).each(upload);
+     * last = corsac::advance_tick();
+     */
+    using Tick = uint32_t;
+
+    namespace internal
+    {
+        inline std::atomic<Tick>& getTick() noexcept
+        {
+            static std::atomic<Tick> tick{1};
+            return tick;
+        }
+
+        // Счетчик для хранилищ, создаваемых в этом потоке: World подставляет свой, nullptr - общий.
+        inline const std::atomic<Tick>*& getTickScope() noexcept
+        {
+            static thread_local const std::atomic<Tick>* scope = nullptr;
+            return scope;
+        }
+
+        /**
+         * change_ticks
+         *
+         * Тики добавления и последнего изменения для каждой позиции packed массива хранилища.
+         * Пока учет выключен, массивы пусты и все операции ничего не делают.
+         * Тики берутся из счетчика, действовавшего при создании (getTickScope()).
+         */
+        template<typename Allocator = default_allocator>
+        class change_ticks
+        {
+        public:
+            using size_type = size_t;
+
+        protected:
+            corsac::vector<Tick, Allocator> added;
+            corsac::vector<Tick, Allocator> changed;
+            const std::atomic<Tick>*        clock   = getTickScope() ? getTickScope() : &getTick();
+            bool                            enabled = false;
+
+        public:
+            [[nodiscard]] bool tracking() const noexcept
+            {
+                return enabled;
+            }
+
+            // Включает учет, уже добавленные n позиций считаются измененными в текущем тике.
+            void enable(size_type n)
+            {
+                enabled = true;
+                const Tick tick = clock->load(std::memory_order_relaxed);
+                added.clear();
+                changed.clear();
+                added.resize(n, tick);
+                changed.resize(n, tick);
+            }
+
+            void disable() noexcept
+            {
+                enabled = false;
+                added.set_capacity(0);
+                changed.set_capacity(0);
+            }
+
+            void push()
+            {
+                if (!enabled)
+                    return;
+                const Tick tick = clock->load(std::memory_order_relaxed);
+                added.push_back(tick);
+                changed.push_back(tick);
+            }
+
+            void touch(size_type pos) noexcept
+            {
+                if (enabled)
+                    changed[pos] = clock->load(std::memory_order_relaxed);
+            }
+
+            // Удаление позиции pos переносом последней, как в packed.
+            void erase(size_type pos) noexcept
+            {
+                if (!enabled)
+                    return;
+                added[pos] = added.back();
+                changed[pos] = changed.back();
+                added.pop_back();
+                changed.pop_back();
+            }
+
+            void swap(size_type lhs, size_type rhs) noexcept
+            {
+                if (!enabled)
+                    return;
+                corsac::swap(added[lhs], added[rhs]);
+                corsac::swap(changed[lhs], changed[rhs]);
+            }
+
+            void resize(size_type n)
+            {
+                if (!enabled)
+                    return;
+                const Tick tick = clock->load(std::memory_order_relaxed);
+                added.resize(n, tick);
+                changed.resize(n, tick);
+            }
+
+            void clear() noexcept
+            {
+                added.clear();
+                changed.clear();
+            }
+
+            void reset_lose_memory() noexcept
+            {
+                added.reset_lose_memory();
+                changed.reset_lose_memory();
+            }
+
+            [[nodiscard]] MemoryUsage memory_usage() const noexcept
+            {
+                MemoryUsage usage;
+                usage.other_used     = (added.size() + changed.size()) * sizeof(Tick);
+                usage.other_capacity = (added.capacity() + changed.capacity()) * sizeof(Tick);
+                return usage;
+            }
+
+            [[nodiscard]] Tick added_at(size_type pos) const noexcept
+            {
+                return enabled ? added[pos] : 0;
+            }
+
+            [[nodiscard]] Tick changed_at(size_type pos) const noexcept
+            {
+                return enabled ? changed[pos] : 0;
+            }
+        };
+    }
+
+    inline Tick current_tick() noexcept
+    {
+        return internal::getTick().load(std::memory_order_relaxed);
+    }
+
+    // Начинает новый тик и возвращает его: изменения после вызова получат тик >= результата.
+    inline Tick advance_tick() noexcept
+    {
+        return internal::getTick().fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+}
+
+#endif //CORSAC_ECS_TICK_H
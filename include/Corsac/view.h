@@ -0,0 +1,275 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_VIEW_H
+#define CORSAC_ECS_VIEW_H
+
+#include "Corsac/component.h"
+#include "Corsac/group.h"
+#include "Corsac/tuple.h"
+
+namespace corsac
+{
+    namespace internal
+    {
+        // Изменена ли сущность с тика tick. Теги, группы и хранилища без учета изменений
+        // отвечают false и не отмечают tracked.
+        template<typename Storage>
+        inline bool changed_since(const Storage& storage, const EntityType& value, Tick tick, bool& tracked) noexcept
+        {
+            if constexpr (Storage::component_type == AOS || Storage::component_type == SOA)
+            {
+                if (storage.tracking())
+                {
+                    tracked = true;
+                    return storage.changed_at(value) >= tick;
+                }
+            }
+            return false;
+        }
+    }
+
+    /**
+     * BasicView
+     *
+     * Соединение нескольких хранилищ по сущностям. Ведущим выбирается хранилище
+     * с наименьшим packed массивом, остальные проверяются через has().
+     * Для каждой сущности отдается tuple<EntityType, ссылки на колонки...>.
+     *
+     * changed_since(tick) оставляет сущности, измененные начиная с tick хотя бы в одном
+     * хранилище с включенным учетом изменений (track_changes).
+     */
+    template<typename... Storages>
+    class BasicView
+    {
+        static_assert(sizeof...(Storages) > 0, "BasicView - at least one storage is required");
+
+        using storage_tuple = corsac::tuple<Storages*...>;
+        using index_sequence = corsac::index_sequence_for<Storages...>;
+
+    public:
+        using size_type = size_t;
+
+        class iterator
+        {
+            const BasicView*  view;
+            const EntityType* current;
+            const EntityType* last;
+
+        public:
+            iterator(const BasicView* v, const EntityType* first, const EntityType* l) noexcept;
+
+            iterator& operator++() noexcept;
+            decltype(auto) operator*() const;
+
+            bool operator==(const iterator& x) const noexcept;
+            bool operator!=(const iterator& x) const noexcept;
+
+        private:
+            void skip() noexcept;
+        };
+
+    protected:
+        storage_tuple storages;
+        Tick          since = 0;
+
+    public:
+        explicit BasicView(Storages&... s) noexcept;
+
+        iterator begin() const noexcept;
+        iterator end() const noexcept;
+
+        template<typename F>
+        void each(F&& f) const;
+
+        [[nodiscard]] bool has(const EntityType& value) const;
+        decltype(auto) get(const EntityType& value) const;
+
+        [[nodiscard]] size_type size_hint() const noexcept;
+
+        [[nodiscard]] BasicView changed_since(Tick tick) const noexcept;
+
+    private:
+        template<size_t... I>
+        bool has(const EntityType& value, corsac::index_sequence<I...>) const;
+
+        template<size_t... I>
+        bool changed(const EntityType& value, corsac::index_sequence<I...>) const;
+
+        template<size_t... I>
+        decltype(auto) get(const EntityType& value, corsac::index_sequence<I...>) const;
+
+        template<size_t... I>
+        void driver(const EntityType*& first, const EntityType*& last, corsac::index_sequence<I...>) const noexcept;
+    };
+
+    template<typename... Storages>
+    inline BasicView<Storages...>::iterator::iterator(const BasicView* v, const EntityType* first, const EntityType* l) noexcept
+        : view(v), current(first), last(l)
+    {
+        skip();
+    }
+
+    template<typename... Storages>
+    inline typename BasicView<Storages...>::iterator& BasicView<Storages...>::iterator::operator++() noexcept
+    {
+        ++current;
+        skip();
+        return *this;
+    }
+
+    template<typename... Storages>
+    inline decltype(auto) BasicView<Storages...>::iterator::operator*() const
+    {
+        return view->get(*current);
+    }
+
+    template<typename... Storages>
+    inline bool BasicView<Storages...>::iterator::operator==(const iterator& x) const noexcept
+    {
+        return current == x.current;
+    }
+
+    template<typename... Storages>
+    inline bool BasicView<Storages...>::iterator::operator!=(const iterator& x) const noexcept
+    {
+        return current != x.current;
+    }
+
+    template<typename... Storages>
+    inline void BasicView<Storages...>::iterator::skip() noexcept
+    {
+        while (current != last && !view->has(*current))
+            ++current;
+    }
+
+    template<typename... Storages>
+    inline BasicView<Storages...>::BasicView(Storages&... s) noexcept
+        : storages(&s...)
+    {}
+
+    template<typename... Storages>
+    inline typename BasicView<Storages...>::iterator BasicView<Storages...>::begin() const noexcept
+    {
+        const EntityType* first;
+        const EntityType* last;
+        driver(first, last, index_sequence());
+        return iterator(this, first, last);
+    }
+
+    template<typename... Storages>
+    inline typename BasicView<Storages...>::iterator BasicView<Storages...>::end() const noexcept
+    {
+        const EntityType* first;
+        const EntityType* last;
+        driver(first, last, index_sequence());
+        return iterator(this, last, last);
+    }
+
+    template<typename... Storages>
+    template<typename F>
+    inline void BasicView<Storages...>::each(F&& f) const
+    {
+        const EntityType* first;
+        const EntityType* last;
+        driver(first, last, index_sequence());
+        for (; first != last; ++first)
+        {
+            if (has(*first))
+                corsac::apply(f, get(*first));
+        }
+    }
+
+    template<typename... Storages>
+    inline bool BasicView<Storages...>::has(const EntityType& value) const
+    {
+        return has(value, index_sequence());
+    }
+
+    template<typename... Storages>
+    inline decltype(auto) BasicView<Storages...>::get(const EntityType& value) const
+    {
+        return get(value, index_sequence());
+    }
+
+    template<typename... Storages>
+    inline typename BasicView<Storages...>::size_type BasicView<Storages...>::size_hint() const noexcept
+    {
+        const EntityType* first;
+        const EntityType* last;
+        driver(first, last, index_sequence());
+        return static_cast<size_type>(last - first);
+    }
+
+    template<typename... Storages>
+    inline BasicView<Storages...> BasicView<Storages...>::changed_since(Tick tick) const noexcept
+    {
+        BasicView view(*this);
+        view.since = tick;
+        return view;
+    }
+
+    template<typename... Storages>
+    template<size_t... I>
+    inline bool BasicView<Storages...>::has(const EntityType& value, corsac::index_sequence<I...>) const
+    {
+        return (corsac::get<I>(storages)->has(value) && ...) && (since == 0 || changed(value, index_sequence()));
+    }
+
+    template<typename... Storages>
+    template<size_t... I>
+    inline bool BasicView<Storages...>::changed(const EntityType& value, corsac::index_sequence<I...>) const
+    {
+        bool tracked = false;
+        const bool result = (internal::changed_since(*corsac::get<I>(storages), value, since, tracked) || ...);
+        return result || !tracked;
+    }
+
+    template<typename... Storages>
+    template<size_t... I>
+    inline decltype(auto) BasicView<Storages...>::get(const EntityType& value, corsac::index_sequence<I...>) const
+    {
+        return corsac::tuple_cat(
+                corsac::tuple<EntityType>(value),
+                internal::component_refs(*corsac::get<I>(storages), corsac::get<I>(storages)->index(value))...
+        );
+    }
+
+    template<typename... Storages>
+    template<size_t... I>
+    inline void BasicView<Storages...>::driver(const EntityType*& first, const EntityType*& last,
+                                               corsac::index_sequence<I...>) const noexcept
+    {
+        size_type count = corsac::get<0>(storages)->size();
+        first = corsac::get<0>(storages)->entities();
+        ((corsac::get<I>(storages)->size() < count
+            ? (count = corsac::get<I>(storages)->size(), first = corsac::get<I>(storages)->entities(), 0)
+            : 0), ...);
+        last = first + count;
+    }
+
+    /**
+     * View
+     *
+     * BasicView над глобальными компонентами и группами.
+     *
+     * for (auto [ent, x, y, dx, dy, speed] : View<Position, Direction, Speed>())
+     *     ...
+     */
+    template<auto&... Components>
+    class View : public BasicView<corsac::remove_reference_t<decltype(Components)>...>
+    {
+        using base_type = BasicView<corsac::remove_reference_t<decltype(Components)>...>;
+
+    public:
+        View() noexcept;
+    };
+
+    template<auto&... Components>
+    inline View<Components...>::View() noexcept
+        : base_type(Components...)
+    {}
+}
+
+#endif //CORSAC_ECS_VIEW_H
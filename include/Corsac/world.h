@@ -0,0 +1,395 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef CORSAC_ECS_WORLD_H
+#define CORSAC_ECS_WORLD_H
+
+#include "Corsac/entity.h"
+#include "Corsac/registry.h"
+#include "Corsac/tick.h"
+#include "Corsac/snapshot.h"
+#include "Corsac/component.h"
+#include "Corsac/view.h"
+
+namespace corsac
+{
+    namespace internal
+    {
+        /**
+         * world_scope
+         *
+         * Пока жив, хранилища, создаваемые в этом потоке, регистрируются в registry и берут
+         * тики из tick. Предыдущая область восстанавливается в leave() или деструкторе.
+         */
+        class world_scope
+        {
+            registry*                previousRegistry;
+            const std::atomic<Tick>* previousTick;
+            bool                     active = true;
+
+        public:
+            world_scope(registry& r, const std::atomic<Tick>& tick) noexcept
+                : previousRegistry(getRegistryScope()), previousTick(getTickScope())
+            {
+                getRegistryScope() = &r;
+                getTickScope() = &tick;
+            }
+
+            world_scope(const world_scope&) = delete;
+            world_scope& operator=(const world_scope&) = delete;
+
+            ~world_scope()
+            {
+                leave();
+            }
+
+            void leave() noexcept
+            {
+                if (!active)
+                    return;
+                getRegistryScope() = previousRegistry;
+                getTickScope() = previousTick;
+                active = false;
+            }
+        };
+
+        template<typename T, typename... Ts>
+        inline constexpr bool is_one_of_v = (corsac::is_same_v<T, Ts> || ...);
+    }
+
+    template<typename World>
+    class WorldEntity;
+
+    /**
+     * World
+     *
+     * Самостоятельный мир: свои хранилища Storages, аллокатор сущностей, реестр сигнатур
+     * и счетчик тиков. Общего изменяемого состояния у миров нет, поэтому разные миры
+     * можно вести из разных потоков. Хранилища различаются типом:
+     *
+     * struct Position : corsac::Component<float, float> {};
+     * struct Health   : corsac::Component<int> {};
+     *
+     * corsac::World<Position, Health> match;
+     * match.create().add<Position>(1.0f, 2.0f).add<Health>(100);
+     * match.view<Position, Health>().each([](corsac::EntityType id, float& x, float& y, int& hp) {});
+     *
+     * Группы и ARCHETYPE компоненты связаны с глобальными хранилищами и в мир не входят.
+     * Сам мир - как одно хранилище: структурные изменения из одного потока за раз.
+     */
+    template<typename... Storages>
+    class World
+    {
+        static_assert(sizeof...(Storages) <= CORSAC_ECS_MAX_COMPONENTS,
+                      "World - more storages than CORSAC_ECS_MAX_COMPONENTS");
+        static_assert(((Storages::component_type != internal::GROUP && Storages::component_type != internal::CHUNK) && ...),
+                      "World - groups and ARCHETYPE components are bound to global storages");
+
+    public:
+        using size_type = size_t;
+        using entity    = WorldEntity<World>;
+
+    protected:
+        // Реестр и счетчик объявлены раньше хранилищ: хранилища снимают с реестра свой бит в деструкторе.
+        internal::registry          registry;
+        std::atomic<Tick>           tick{1};
+        EntityAllocator<EntityType> allocator;
+        internal::world_scope       scope;
+        corsac::tuple<Storages...>  storages;
+
+    public:
+        World();
+
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        template<typename Storage>
+        Storage& storage() noexcept;
+
+        template<typename Storage>
+        const Storage& storage() const noexcept;
+
+        entity create();
+        entity get(const EntityType& value) noexcept;
+
+        // Создает n сущностей блоком ID подряд.
+        EntityRange create_n(size_type n);
+
+        [[nodiscard]] bool      valid(const EntityType& value) const noexcept;
+        [[nodiscard]] size_type alive() const noexcept;
+
+        // Удаляет сущность из всех хранилищ мира и освобождает ID.
+        void destroy(const EntityType& value);
+
+        // Несколько хранилищ проверяются одним сравнением сигнатуры в реестре мира.
+        template<typename... Components>
+        [[nodiscard]] bool has(const EntityType& value) const;
+
+        template<typename... Components>
+        BasicView<Components...> view() noexcept;
+
+        // Тики мира, см. corsac::current_tick и corsac::advance_tick.
+        [[nodiscard]] Tick current_tick() const noexcept;
+        Tick advance_tick() noexcept;
+
+        // Снимок аллокатора и всех хранилищ в порядке Storages.
+        void snapshot(Snapshot& out) const;
+        bool restore(Snapshot& in);
+
+        // Пустой мир: хранилища и аллокатор очищаются, память остается.
+        void clear() noexcept;
+
+        // Память всех хранилищ, аллокатора и реестра мира, entities и max_id - по аллокатору.
+        [[nodiscard]] MemoryUsage memory_usage() const noexcept;
+    };
+
+    /**
+     * WorldEntity
+     *
+     * Сущность мира с тем же интерфейсом, что у Entity: хранилище задается типом.
+     */
+    template<typename World>
+    class WorldEntity
+    {
+        World*     world;
+        EntityType ID;
+
+    public:
+        WorldEntity(World& w, EntityType id) noexcept;
+
+        [[nodiscard]] EntityType id() const noexcept;
+        [[nodiscard]] bool       valid() const noexcept;
+
+        template<typename... Components>
+        [[nodiscard]] bool has() const;
+
+        template<typename Component, size_t I>
+        decltype(auto) get();
+
+        template<typename Component>
+        decltype(auto) get();
+
+        template<typename Component, typename... Args>
+        WorldEntity add(Args&&... data);
+
+        template<typename Component, typename... Args>
+        WorldEntity set(Args&&... data);
+
+        template<typename Component, typename... Args>
+        WorldEntity fit(Args&&... data);
+
+        template<typename Component>
+        WorldEntity remove();
+
+        void destroy();
+    };
+
+    template<typename... Storages>
+    inline World<Storages...>::World()
+        : scope(registry, tick)
+    {
+        scope.leave();
+    }
+
+    template<typename... Storages>
+    template<typename Storage>
+    inline Storage& World<Storages...>::storage() noexcept
+    {
+        static_assert(internal::is_one_of_v<Storage, Storages...>, "World::storage - storage is not part of the world");
+        return corsac::get<Storage>(storages);
+    }
+
+    template<typename... Storages>
+    template<typename Storage>
+    inline const Storage& World<Storages...>::storage() const noexcept
+    {
+        static_assert(internal::is_one_of_v<Storage, Storages...>, "World::storage - storage is not part of the world");
+        return corsac::get<Storage>(storages);
+    }
+
+    template<typename... Storages>
+    inline typename World<Storages...>::entity World<Storages...>::create()
+    {
+        return entity(*this, allocator.create());
+    }
+
+    template<typename... Storages>
+    inline typename World<Storages...>::entity World<Storages...>::get(const EntityType& value) noexcept
+    {
+        return entity(*this, value);
+    }
+
+    template<typename... Storages>
+    inline EntityRange World<Storages...>::create_n(size_type n)
+    {
+        return EntityRange(allocator.create_n(n), n);
+    }
+
+    template<typename... Storages>
+    inline bool World<Storages...>::valid(const EntityType& value) const noexcept
+    {
+        return allocator.valid(value);
+    }
+
+    template<typename... Storages>
+    inline typename World<Storages...>::size_type World<Storages...>::alive() const noexcept
+    {
+        return allocator.alive();
+    }
+
+    template<typename... Storages>
+    inline void World<Storages...>::destroy(const EntityType& value)
+    {
+        registry.destroy(value);
+        allocator.destroy(value);
+    }
+
+    template<typename... Storages>
+    template<typename... Components>
+    inline bool World<Storages...>::has(const EntityType& value) const
+    {
+        if constexpr (sizeof...(Components) == 1)
+            return (storage<Components>().has(value) && ...);
+        else
+        {
+            internal::signature mask;
+            bool registered = true;
+            ((storage<Components>().signature_bit() != internal::registry_npos
+                    ? mask.set(storage<Components>().signature_bit())
+                    : void(registered = false)), ...);
+            if (!registered)
+                return (storage<Components>().has(value) && ...);
+            return registry.has(value, mask);
+        }
+    }
+
+    template<typename... Storages>
+    template<typename... Components>
+    inline BasicView<Components...> World<Storages...>::view() noexcept
+    {
+        return BasicView<Components...>(storage<Components>()...);
+    }
+
+    template<typename... Storages>
+    inline Tick World<Storages...>::current_tick() const noexcept
+    {
+        return tick.load(std::memory_order_relaxed);
+    }
+
+    template<typename... Storages>
+    inline Tick World<Storages...>::advance_tick() noexcept
+    {
+        return tick.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    template<typename... Storages>
+    inline void World<Storages...>::snapshot(Snapshot& out) const
+    {
+        allocator.snapshot(out);
+        (storage<Storages>().snapshot(out), ...);
+    }
+
+    template<typename... Storages>
+    inline bool World<Storages...>::restore(Snapshot& in)
+    {
+        return allocator.restore(in) && (storage<Storages>().restore(in) && ...);
+    }
+
+    template<typename... Storages>
+    inline void World<Storages...>::clear() noexcept
+    {
+        (storage<Storages>().clear(), ...);
+        allocator.clear();
+    }
+
+    template<typename... Storages>
+    inline MemoryUsage World<Storages...>::memory_usage() const noexcept
+    {
+        const MemoryUsage entities = allocator.memory_usage();
+        MemoryUsage usage = registry.memory_usage();
+        ((usage += storage<Storages>().memory_usage()), ...);
+        usage += entities;
+        usage.entities = entities.entities;
+        usage.max_id   = entities.max_id;
+        return usage;
+    }
+
+    template<typename World>
+    inline WorldEntity<World>::WorldEntity(World& w, EntityType id) noexcept
+        : world(&w), ID(id)
+    {}
+
+    template<typename World>
+    inline EntityType WorldEntity<World>::id() const noexcept
+    {
+        return ID;
+    }
+
+    template<typename World>
+    inline bool WorldEntity<World>::valid() const noexcept
+    {
+        return world->valid(ID);
+    }
+
+    template<typename World>
+    template<typename... Components>
+    inline bool WorldEntity<World>::has() const
+    {
+        return world->template has<Components...>(ID);
+    }
+
+    template<typename World>
+    template<typename Component, size_t I>
+    inline decltype(auto) WorldEntity<World>::get()
+    {
+        return world->template storage<Component>().template get<I>(ID);
+    }
+
+    template<typename World>
+    template<typename Component>
+    inline decltype(auto) WorldEntity<World>::get()
+    {
+        return world->template storage<Component>().get(ID);
+    }
+
+    template<typename World>
+    template<typename Component, typename... Args>
+    inline WorldEntity<World> WorldEntity<World>::add(Args&&... data)
+    {
+        world->template storage<Component>().add(ID, data...);
+        return *this;
+    }
+
+    template<typename World>
+    template<typename Component, typename... Args>
+    inline WorldEntity<World> WorldEntity<World>::set(Args&&... data)
+    {
+        world->template storage<Component>().set(ID, data...);
+        return *this;
+    }
+
+    template<typename World>
+    template<typename Component, typename... Args>
+    inline WorldEntity<World> WorldEntity<World>::fit(Args&&... data)
+    {
+        world->template storage<Component>().fit(ID, data...);
+        return *this;
+    }
+
+    template<typename World>
+    template<typename Component>
+    inline WorldEntity<World> WorldEntity<World>::remove()
+    {
+        world->template storage<Component>().remove(ID);
+        return *this;
+    }
+
+    template<typename World>
+    inline void WorldEntity<World>::destroy()
+    {
+        world->destroy(ID);
+    }
+}
+
+#endif //CORSAC_ECS_WORLD_H
@@ -0,0 +1,105 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_ARCHETYPE_TEST_H
+#define ECS_ARCHETYPE_TEST_H
+
+#include "Corsac/archetype.h"
+#include "Corsac/group.h"
+
+namespace archetype_test_data
+{
+    inline corsac::Component<float, float>::Config<corsac::ARCHETYPE> Position;
+    inline corsac::Component<float>::Config<corsac::ARCHETYPE> Speed;
+    inline corsac::Component<>::Config<corsac::ARCHETYPE> Frozen;
+}
+
+bool archetype_test(corsac::Block* assert) {
+
+    using namespace archetype_test_data;
+
+    assert->add_block("chunks", [](corsac::Block *assert) {
+        // Строка Position + Speed - 16 байт, 3000 сущностей занимают несколько чанков.
+        const corsac::EntityType count = 3000;
+        for (corsac::EntityType i = 0; i < count; ++i)
+        {
+            Position.add(i, static_cast<float>(i), 0.0f);
+            if (i % 2 == 0)
+                Speed.add(i, 2.0f);
+        }
+        assert->equal("size()", Position.size(), count);
+        assert->equal("view size()", corsac::ArchetypeView<Position, Speed>().size(), count / 2);
+
+        // Перенос в другой архетип сохраняет значения.
+        assert->equal("moved value", Position.get<0>(10), 10.0f);
+        assert->equal("added value", Speed.get(10), 2.0f);
+        assert->is_false("not in archetype", Speed.has(11));
+
+        corsac::ArchetypeView<Position, Speed>().each([](corsac::EntityType, float& x, float& y, float& dx) {
+            x += dx;
+            y -= dx;
+        });
+        assert->equal("each", Position.get<0>(10), 12.0f);
+        assert->equal("each field", Position.get<1>(10), -2.0f);
+        assert->equal("not visited", Position.get<0>(11), 11.0f);
+
+        size_t rows = 0;
+        size_t chunks = 0;
+        corsac::ArchetypeView<Speed>().each_chunk([&rows, &chunks](size_t n, const corsac::EntityType* ents, float* dx) {
+            rows += n;
+            ++chunks;
+            if (ents[0] % 2 != 0 || static_cast<int>(dx[n - 1]) != 2)
+                rows = 0;
+        });
+        assert->equal("each_chunk", rows, count / 2);
+        assert->is_true("several chunks", chunks > 1);
+
+        // Удаление из середины архетипа переносит на свое место последнюю строку.
+        for (corsac::EntityType i = 0; i < count; i += 4)
+            Speed.remove(i);
+        assert->equal("removed size()", Speed.size(), count / 4);
+        assert->is_false("removed", Speed.has(0));
+        assert->equal("kept value", Position.get<0>(0), 2.0f);
+        assert->equal("swapped row", Position.get<0>(count - 2), static_cast<float>(count));
+        assert->equal("swapped speed", Speed.get(count - 2), 2.0f);
+
+        for (corsac::EntityType i = 0; i < count; ++i)
+        {
+            Position.remove(i);
+            Speed.remove(i);
+        }
+        assert->is_true("empty()", Position.empty() && Speed.empty());
+        assert->equal("empty view", corsac::ArchetypeView<Position>().size(), 0);
+    });
+
+    assert->add_block("entity", [](corsac::Block *assert) {
+        corsac::Entity<Frozen> ent;
+        ent.add<Position>(1.0f, 2.0f).set<Speed>(3.0f);
+        assert->is_true("has()", ent.has<Frozen>() && ent.has<Position>());
+        assert->equal("get()", ent.get<Speed>(), 3.0f);
+        assert->equal("get<I>()", (ent.get<Position, 1>()), 2.0f);
+
+        ent.fit<Position>(4.0f, 5.0f).remove<Frozen>();
+        assert->is_false("remove()", ent.has<Frozen>());
+        assert->equal("fit()", (ent.get<Position, 0>()), 4.0f);
+        assert->equal("view", corsac::ArchetypeView<Position, Speed>().size(), 1);
+
+        // destroy() снимает строку без ручных remove.
+        ent.add<Frozen>();
+        const corsac::EntityType id = ent.id();
+        ent.destroy();
+        assert->is_false("destroy()", Position.has(id) || Speed.has(id) || Frozen.has(id));
+        assert->is_true("destroy() size()", Position.empty() && Speed.empty() && Frozen.empty());
+        assert->equal("destroy() view", corsac::ArchetypeView<Position>().size(), 0);
+        size_t visited = 0;
+        corsac::ArchetypeView<Position, Speed>().each([&visited](corsac::EntityType, float&, float&, float&) {
+            ++visited;
+        });
+        assert->equal("destroy() each", visited, 0);
+    });
+
+    return true;
+}
+
+#endif //ECS_ARCHETYPE_TEST_H
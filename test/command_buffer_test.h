@@ -0,0 +1,106 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_COMMAND_BUFFER_TEST_H
+#define ECS_COMMAND_BUFFER_TEST_H
+
+#include "Corsac/command_buffer.h"
+#include "Corsac/system.h"
+
+#include <atomic>
+
+namespace command_buffer_test_data
+{
+    inline corsac::Component<int, int> Position;
+    inline corsac::Component<int> Health;
+    inline corsac::Component<> Dead;
+
+    inline corsac::Group<Position, Health> Unit;
+}
+
+bool command_buffer_test(corsac::Block* assert) {
+
+    using namespace command_buffer_test_data;
+
+    assert->add_block("deferred", [](corsac::Block *assert) {
+        corsac::CommandBuffer commands;
+        for (corsac::EntityType i = 0; i < 10; ++i)
+            Dead.add(i);
+
+        // Удаление из обходимого хранилища не сдвигает обход.
+        int visited = 0;
+        for (auto ent : Dead)
+        {
+            commands.remove<Dead>(ent);
+            ++visited;
+        }
+        assert->equal("visited all", visited, 10);
+        assert->equal("size()", commands.size(), 10);
+        assert->equal("not applied", Dead.size(), 10);
+
+        const corsac::EntityType ent = commands.create<Unit>();
+        commands.fit<Position>(ent, 3, 4).set<Health>(ent, 7);
+        commands.flush();
+        assert->is_true("empty()", commands.empty());
+        assert->is_true("removed", Dead.empty());
+        assert->is_true("created", Unit.has(ent));
+        assert->equal("fit", Position.get<1>(ent), 4);
+        assert->equal("set", Health.get(ent), 7);
+
+        commands.destroy<Unit>(ent);
+        commands.flush();
+        assert->is_false("destroyed", Position.has(ent));
+        assert->is_false("id released", corsac::internal::getEntityAllocator().valid(ent));
+    });
+    assert->add_block("per thread", [](corsac::Block *assert) {
+        for (corsac::EntityType i = 100; i < 200; ++i)
+            Health.add(i, static_cast<int>(i));
+
+        corsac::ThreadPool pool(4);
+        corsac::CommandBuffers commands(pool);
+        corsac::System(Health, pool, [&commands](corsac::EntityType ent, int& hp) {
+            if (hp % 2 == 0)
+                commands.local().add<Dead>(ent);
+        }, 8);
+        commands.flush();
+        assert->equal("merged", Dead.size(), 50);
+    });
+    assert->add_block("two pools", [](corsac::Block *assert) {
+        corsac::ThreadPool small(2);
+        corsac::ThreadPool large(6);
+        corsac::CommandBuffers commands(small);
+
+        // Потоки большого пула пишут одновременно, каждый в свой буфер, а не в буфер 0 или за границу.
+        std::atomic<bool> foreign{true};
+        for (int task = 0; task < 12; ++task)
+        {
+            large.submit([&commands, &foreign, task] {
+                corsac::CommandBuffer& buffer = commands.local();
+                foreign = foreign && &buffer == &commands.local() && &buffer != &commands[0];
+                for (corsac::EntityType i = 0; i < 50; ++i)
+                    buffer.add<Dead>(1000 + static_cast<corsac::EntityType>(task) * 50 + i);
+            });
+        }
+        large.wait();
+        assert->is_true("foreign threads use own buffers", foreign);
+
+        std::atomic<bool> own{true};
+        small.parallel_for(64, 1, [&commands, &own](size_t, size_t) {
+            const size_t index = corsac::ThreadPool::current_index();
+            own = own && index < commands.size() && &commands.local() == &commands[index];
+        });
+        assert->is_true("own threads use their slot", own);
+
+        large.submit([&commands] { commands.local().add<Dead>(300); });
+        large.wait();
+        commands.flush();
+        bool flushed = Dead.has(300);
+        for (corsac::EntityType i = 1000; i < 1600; ++i)
+            flushed = flushed && Dead.has(i);
+        assert->is_true("flushed", flushed);
+    });
+    return true;
+}
+
+#endif //ECS_COMMAND_BUFFER_TEST_H
@@ -0,0 +1,86 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_DELTA_TEST_H
+#define ECS_DELTA_TEST_H
+
+#include "Corsac/delta.h"
+
+namespace delta_test_data
+{
+    inline corsac::Component<int, float> Position;
+    inline corsac::Component<int> Health;
+    inline corsac::Component<> Alive;
+
+    inline corsac::OwningGroup<Position, Health> Unit;
+}
+
+bool delta_test(corsac::Block* assert) {
+
+    using namespace delta_test_data;
+
+    assert->add_block("autosave", [](corsac::Block *assert) {
+        const corsac::EntityRange ids = corsac::Entity<Unit>::create_n(1000);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            Position.get<0>(ids[i]) = static_cast<int>(i);
+            Position.get<1>(ids[i]) = static_cast<float>(i) * 0.5f;
+            Health.get(ids[i]) = 100;
+        }
+        Health.track_changes();
+
+        // Полный снимок и первая дельта - одно и то же состояние.
+        corsac::Snapshot base;
+        corsac::snapshot<Position, Health, Alive, Unit>(base);
+        corsac::DeltaEncoder<Position, Health, Alive, Unit> encoder;
+        corsac::Snapshot full;
+        encoder.encode(full);
+        assert->is_true("first delta is full", full.size() > 3000);
+
+        corsac::advance_tick();
+        Position.get<0>(ids[5]) += 1;
+        Health.get(ids[7]) = 3;
+        corsac::Entity<Unit>(ids[9]).destroy();
+        corsac::Entity<Unit> fresh;
+        fresh.fit<Position>(77, 7.5f);
+        Alive.add(ids[3]);
+        const size_t alive = corsac::internal::getEntityAllocator().alive();
+
+        corsac::Snapshot changes;
+        encoder.encode(changes);
+        assert->is_true("delta follows changes", changes.size() < 128);
+
+        corsac::Snapshot quiet;
+        encoder.encode(quiet);
+        assert->is_true("no changes", quiet.size() < changes.size());
+
+        base.rewind();
+        corsac::restore<Position, Health, Alive, Unit>(base);
+        assert->equal("restored", Position.get<0>(ids[5]), 5);
+
+        assert->is_true("apply_delta()", corsac::apply_delta<Position, Health, Alive, Unit>(changes));
+        assert->equal("remaining()", changes.remaining(), 0);
+        assert->equal("modified column", Position.get<0>(ids[5]), 6);
+        assert->equal("other column", Position.get<1>(ids[5]), 2.5f);
+        assert->equal("modified AoS", Health.get(ids[7]), 3);
+        assert->is_false("removed", Unit.has(ids[9]) || Position.has(ids[9]) || Health.has(ids[9]));
+        assert->is_true("added", fresh.valid() && Unit.has(fresh.id()));
+        assert->equal("added value", Position.get<1>(fresh.id()), 7.5f);
+        assert->is_true("tag", Alive.has(ids[3]) && !Alive.has(ids[4]));
+        assert->equal("allocator", corsac::internal::getEntityAllocator().alive(), alive);
+        assert->equal("owning prefix", Position.entities()[Unit.index(fresh.id())], fresh.id());
+
+        assert->is_true("empty delta", corsac::apply_delta<Position, Health, Alive, Unit>(quiet));
+        assert->equal("unchanged", Health.get(ids[7]), 3);
+
+        changes.rewind();
+        bool rejected = false;
+        try { rejected = !corsac::apply_delta<Position, Health>(changes); }
+        catch (const std::invalid_argument&) { rejected = true; }
+        assert->is_true("storage list checked", rejected);
+    });
+    return true;
+}
+
+#endif //ECS_DELTA_TEST_H
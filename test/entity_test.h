@@ -0,0 +1,165 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_ENTITY_TEST_H
+#define ECS_ENTITY_TEST_H
+
+#include "Corsac/entity.h"
+#include "Corsac/sparse_set.h"
+#include "Corsac/group.h"
+
+#include <memory>
+#include <optional>
+
+namespace entity_test_data
+{
+    inline corsac::Component<int, int> Position;
+    inline corsac::Component<int> Health;
+    inline corsac::Component<> Frozen;
+
+    inline corsac::OwningGroup<Position, Health> Unit;
+
+    // Бит Released освобождается до создания группы над ReusedA и ReusedB.
+    inline std::optional<corsac::Component<int>> Released{std::in_place};
+    inline corsac::Component<int> ReusedA;
+    inline corsac::Component<int> ReusedB;
+}
+
+bool entity_test(corsac::Block* assert) {
+
+    using traits = corsac::entity_traits<corsac::EntityType>;
+
+    assert->add_block("traits", [](corsac::Block *assert) {
+        const corsac::EntityType value = traits::combine(42, 3);
+        assert->equal("index()", traits::index(value), 42);
+        assert->equal("version()", traits::version(value), 3);
+        assert->equal("version() wraps", traits::version(traits::combine(42, traits::version_mask + 1)), 0);
+    });
+    assert->add_block("allocator", [](corsac::Block *assert) {
+        corsac::EntityAllocator<> allocator;
+        const corsac::EntityType first = allocator.create();
+        const corsac::EntityType second = allocator.create();
+        assert->equal("alive()", allocator.alive(), 2);
+        assert->is_true("valid(first)", allocator.valid(first));
+
+        allocator.destroy(first);
+        assert->is_false("valid(destroyed)", allocator.valid(first));
+        assert->equal("alive()", allocator.alive(), 1);
+
+        const corsac::EntityType recycled = allocator.create();
+        assert->equal("index reused", traits::index(recycled), traits::index(first));
+        assert->equal("version bumped", traits::version(recycled), traits::version(first) + 1);
+        assert->equal("size()", allocator.size(), 2);
+        assert->is_true("valid(second)", allocator.valid(second));
+    });
+    assert->add_block("stale handle", [](corsac::Block *assert) {
+        corsac::EntityAllocator<> allocator;
+        corsac::sparse_set<corsac::EntityType> set;
+        const corsac::EntityType stale = allocator.create();
+        set.add(stale);
+        set.remove(stale);
+        allocator.destroy(stale);
+
+        const corsac::EntityType recycled = allocator.create();
+        set.add(recycled);
+        assert->is_true("has(recycled)", set.has(recycled));
+        assert->is_false("has(stale)", set.has(stale));
+    });
+    assert->add_block("registry", [](corsac::Block *assert) {
+        using namespace entity_test_data;
+
+        corsac::Entity<Unit> unit;
+        corsac::Entity<> plain;
+        plain.add<Position>(1, 2).add<Frozen>();
+
+        assert->is_true("has<Position, Health>", unit.has<Position, Health>());
+        assert->is_true("has<Unit, Position>", unit.has<Unit, Position>());
+        assert->is_false("has<Position, Frozen>", unit.has<Position, Frozen>());
+        assert->is_true("has<Position, Frozen>", plain.has<Position, Frozen>());
+        assert->is_false("has<Position, Health>", plain.has<Position, Health>());
+
+        const corsac::internal::signature s = corsac::internal::getRegistry().of(unit.id());
+        assert->is_true("group bit", s.test(Unit.signature_bit()));
+        assert->is_false("foreign bit", s.test(Frozen.signature_bit()));
+
+        // destroy() без Group знает хранилища сущности по сигнатуре.
+        const corsac::EntityType id = plain.id();
+        corsac::Entity<>(id).destroy();
+        assert->is_false("removed from Position", Position.has(id));
+        assert->is_false("removed from Frozen", Frozen.has(id));
+
+        unit.destroy();
+        assert->is_false("removed from Unit", Unit.has(unit.id()));
+        assert->is_false("removed from Health", Health.has(unit.id()));
+        assert->equal("owning prefix", Unit.size(), 0);
+
+        // Сигнатура новой версии индекса не видна по старому ID.
+        const corsac::EntityType next = traits::combine(traits::index(id), traits::version(id) + 1);
+        Health.add(next, 5);
+        assert->is_true("next version", corsac::Entity<>(next).has<Health, Health>());
+        assert->is_false("stale version", corsac::Entity<>(id).has<Health, Health>());
+        Health.remove(next);
+    });
+    assert->add_block("registry reused bit", [](corsac::Block *assert) {
+        using namespace entity_test_data;
+
+        Released.reset();
+        const auto group = std::make_unique<corsac::OwningGroup<ReusedA, ReusedB>>();
+        assert->is_true("group bit below members", group->signature_bit() < ReusedA.signature_bit());
+
+        corsac::EntityType ids[3];
+        for (corsac::EntityType& id : ids)
+        {
+            id = corsac::internal::getNewEntityTypeID();
+            group->add(id);
+        }
+        corsac::Entity<>(ids[0]).destroy();
+
+        assert->is_false("removed from group", group->has(ids[0]));
+        assert->is_false("removed from member", ReusedA.has(ids[0]) || ReusedB.has(ids[0]));
+        assert->equal("owning prefix", group->size(), 2);
+        bool aligned = true;
+        for (size_t i = 1; i < 3; ++i)
+            aligned = aligned && ReusedA.index(ids[i]) == group->index(ids[i]) && ReusedB.index(ids[i]) == group->index(ids[i]);
+        assert->is_true("members aligned", aligned);
+
+        for (size_t i = 1; i < 3; ++i)
+            corsac::Entity<>(ids[i]).destroy();
+    });
+    assert->add_block("registry growth", [](corsac::Block *assert) {
+        corsac::internal::registry registry;
+        size_t reallocations = 0;
+        size_t capacity = 0;
+        for (corsac::EntityType i = 0; i < 10000; ++i)
+        {
+            registry.set(i, 0);
+            reallocations += registry.memory_usage().other_capacity != capacity;
+            capacity = registry.memory_usage().other_capacity;
+        }
+        assert->is_true("amortized", reallocations < 32);
+        assert->is_true("set", registry.of(9999).test(0));
+    });
+    assert->add_block("registry overflow", [](corsac::Block *assert) {
+        constexpr size_t count = CORSAC_ECS_MAX_COMPONENTS + 8;
+        corsac::internal::registry registry;
+        corsac::internal::registry* const previous = corsac::internal::getRegistryScope();
+        corsac::internal::getRegistryScope() = &registry;
+        std::unique_ptr<corsac::Component<int>[]> storages(new corsac::Component<int>[count]);
+        corsac::internal::getRegistryScope() = previous;
+
+        assert->is_true("last has bit", storages[CORSAC_ECS_MAX_COMPONENTS - 1].signature_bit() != corsac::internal::registry_npos);
+        assert->equal("no bit", storages[count - 1].signature_bit(), corsac::internal::registry_npos);
+
+        for (size_t i = 0; i < count; ++i)
+            storages[i].add(7, static_cast<int>(i));
+        registry.destroy(7);
+        bool removed = true;
+        for (size_t i = 0; i < count; ++i)
+            removed = removed && !storages[i].has(7);
+        assert->is_true("destroy reaches every storage", removed);
+    });
+    return true;
+}
+
+#endif //ECS_ENTITY_TEST_H
@@ -0,0 +1,99 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_GROUP_TEST_H
+#define ECS_GROUP_TEST_H
+
+#include "Corsac/group.h"
+#include "Corsac/system.h"
+
+namespace group_test_data
+{
+    inline corsac::Component<int, int> Position;
+    inline corsac::Component<int> Speed;
+
+    inline corsac::OwningGroup<Position, Speed> Moving;
+    inline corsac::Group<Moving> Tracked;
+
+    // Хранилища create_n без ID, добавленных в обход аллокатора.
+    inline corsac::Component<int, int> BatchPosition;
+    inline corsac::Component<int> BatchSpeed;
+
+    inline corsac::OwningGroup<BatchPosition, BatchSpeed> BatchMoving;
+    inline corsac::Group<BatchMoving> BatchTracked;
+
+    inline auto Step = [](corsac::EntityType, int& x, int& y, int& speed) {
+        x += speed;
+        y = static_cast<int>(speed);
+    };
+}
+
+bool group_test(corsac::Block* assert) {
+
+    using namespace group_test_data;
+
+    assert->add_block("owning", [](corsac::Block *assert) {
+        // Сущности вне группы занимают начало компонентов до создания группы.
+        Position.add(100, 1, 1);
+        Speed.add(200, 1);
+        Speed.add(101, 1);
+
+        for (corsac::EntityType i = 1; i <= 6; ++i)
+            Moving.add(i);
+        Moving.remove(2);
+        Moving.remove(6);
+        Moving.add(101);
+
+        bool aligned = true;
+        for (size_t i = 0; i < Moving.size(); ++i)
+        {
+            aligned = aligned && Position.entities()[i] == Moving.entities()[i]
+                              && Speed.entities()[i] == Moving.entities()[i];
+        }
+        assert->equal("size()", Moving.size(), 5);
+        assert->is_true("prefix aligned", aligned);
+        assert->is_false("has(removed)", Position.has(2));
+        assert->is_true("outsider kept", Position.has(100) && Speed.has(200));
+        assert->equal("value follows entity", Position.get<0>(100), 1);
+    });
+    assert->add_block("system", [](corsac::Block *assert) {
+        for (corsac::EntityType i = 300; i < 400; ++i)
+        {
+            Tracked.add(i);
+            Speed.fit(i, 2);
+        }
+
+        corsac::System<Step>(Moving);
+        assert->equal("owning group", Position.get<0>(350), 2);
+
+        corsac::ThreadPool pool(4);
+        corsac::System<Step>(Tracked, pool, 16);
+        assert->equal("nested group in parallel", Position.get<0>(399), 4);
+        assert->equal("second column", Position.get<1>(300), 2);
+
+        int count = 0;
+        corsac::System(Speed, [&count](corsac::EntityType, int&) {
+            ++count;
+        });
+        assert->equal("component", count, static_cast<int>(Speed.size()));
+    });
+    assert->add_block("create_n", [](corsac::Block *assert) {
+        const size_t before = BatchMoving.size();
+        const corsac::EntityRange range = corsac::Entity<BatchTracked>::create_n(1000);
+        assert->equal("size()", range.size(), 1000);
+        assert->equal("contiguous", range[999] - range[0], 999);
+        assert->equal("group grew", BatchMoving.size(), before + 1000);
+        assert->equal("tracked grew", BatchTracked.size(), before + 1000);
+        assert->equal("components grew", BatchPosition.size() + BatchSpeed.size(), 2 * (before + 1000));
+        assert->is_true("member", BatchPosition.has(range[500]) && BatchSpeed.has(range[500]));
+
+        bool aligned = true;
+        for (size_t i = 0; i < BatchMoving.size(); ++i)
+            aligned = aligned && BatchPosition.entities()[i] == BatchMoving.entities()[i];
+        assert->is_true("prefix aligned", aligned);
+    });
+    return true;
+}
+
+#endif //ECS_GROUP_TEST_H
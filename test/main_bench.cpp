@@ -0,0 +1,198 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#include "Corsac/ecs.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+void* operator new[](size_t size, const char*, int, unsigned, const char*, int)
+{
+    return new uint8_t[size];
+}
+
+void* operator new[](size_t size, size_t, size_t, const char*, int, unsigned, const char*, int)
+{
+    return new uint8_t[size];
+}
+
+/*
+ * ECS_Bench [max_entities] [--json]
+ *
+ * Одна строка на замер: benchmark,storage,entities,ns,ns_per_entity (CSV, по умолчанию)
+ * или объект JSON на строку с теми же полями. Замеры итерации - лучший из CORSAC_BENCH_REPEAT.
+ * max_entities отбрасывает размеры больше заданного, по умолчанию идут 10k, 1M и 10M.
+ */
+
+#ifndef CORSAC_BENCH_REPEAT
+    #define CORSAC_BENCH_REPEAT 5
+#endif
+
+namespace bench
+{
+    using clock = std::chrono::steady_clock;
+
+    inline bool json = false;
+    inline volatile int64_t sink = 0;
+
+    void report(const char* benchmark, const char* storage, size_t entities, uint64_t ns)
+    {
+        const double perEntity = static_cast<double>(ns) / static_cast<double>(entities);
+        if (json)
+            std::printf("{\"benchmark\":\"%s\",\"storage\":\"%s\",\"entities\":%zu,\"ns\":%llu,\"ns_per_entity\":%.3f}\n",
+                        benchmark, storage, entities, static_cast<unsigned long long>(ns), perEntity);
+        else
+            std::printf("%s,%s,%zu,%llu,%.3f\n",
+                        benchmark, storage, entities, static_cast<unsigned long long>(ns), perEntity);
+        std::fflush(stdout);
+    }
+
+    template<typename F>
+    uint64_t measure(F&& f)
+    {
+        const auto start = clock::now();
+        f();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+    }
+
+    template<typename F>
+    uint64_t best(F&& f)
+    {
+        uint64_t result = measure(f);
+        for (int i = 1; i < CORSAC_BENCH_REPEAT; ++i)
+            result = corsac::min(result, measure(f));
+        return result;
+    }
+
+    void entities(size_t n)
+    {
+        auto allocator = std::make_unique<corsac::EntityAllocator<corsac::EntityType>>();
+        allocator->reserve(n);
+        report("create", "entity", n, measure([&] {
+            for (size_t i = 0; i < n; ++i)
+                allocator->create();
+        }));
+        report("destroy", "entity", n, measure([&] {
+            for (size_t i = 0; i < n; ++i)
+                allocator->destroy(static_cast<corsac::EntityType>(i));
+        }));
+        report("create_n", "entity", n, measure([&] {
+            allocator->clear();
+            allocator->create_n(n);
+        }));
+    }
+
+    // Полный цикл хранилищ C с емкостью N: вставка, доступ, итерация одного и двух компонентов, удаление.
+    template<corsac::ComponentContainerType C, size_t N>
+    void storage(const char* name, size_t n)
+    {
+        using Position = typename corsac::Component<int, float>::template Config<C, N>;
+        using Health   = typename corsac::Component<int>::template Config<C, N>;
+
+        // FIXED и STATIC хранят N элементов в самом объекте, поэтому хранилища живут в куче.
+        auto position = std::make_unique<Position>();
+        auto health   = std::make_unique<Health>();
+        const auto count = static_cast<corsac::EntityType>(n);
+
+        report("add", name, n, measure([&] {
+            for (corsac::EntityType i = 0; i < count; ++i)
+                position->add(i, static_cast<int>(i), 1.0f);
+        }));
+        for (corsac::EntityType i = 0; i < count; i += 2)
+            health->add(i, 1);
+
+        report("has", name, n, best([&] {
+            int64_t found = 0;
+            for (corsac::EntityType i = 0; i < count; ++i)
+                found += health->has(i);
+            sink = found;
+        }));
+        report("get", name, n, best([&] {
+            int64_t sum = 0;
+            for (corsac::EntityType i = 0; i < count; ++i)
+                sum += position->template get<0>(i);
+            sink = sum;
+        }));
+        report("iterate_1", name, n, best([&] {
+            int64_t sum = 0;
+            corsac::System(*position, [&sum](corsac::EntityType, int& x, float&) { sum += x; });
+            sink = sum;
+        }));
+        report("iterate_2", name, n, best([&] {
+            int64_t sum = 0;
+            corsac::BasicView<Position, Health>(*position, *health).each(
+                    [&sum](corsac::EntityType, int& x, float&, int& hp) { sum += x + hp; });
+            sink = sum;
+        }));
+        report("remove", name, n, measure([&] {
+            for (corsac::EntityType i = 0; i < count; ++i)
+                position->remove(i);
+        }));
+    }
+
+    inline corsac::Component<int, float> Position;
+    inline corsac::Component<int> Health;
+    inline corsac::Group<Position, Health> Unit;
+
+    inline corsac::Component<int, float> OwnedPosition;
+    inline corsac::Component<int> OwnedHealth;
+    inline corsac::OwningGroup<OwnedPosition, OwnedHealth> OwnedUnit;
+
+    inline int64_t total = 0;
+    inline auto Step = [](corsac::EntityType, int& x, float&, int& hp) { total += x + hp; };
+
+    template<auto& Group>
+    void group(const char* name, size_t n)
+    {
+        const auto count = static_cast<corsac::EntityType>(n);
+        report("group_add", name, n, measure([&] {
+            for (corsac::EntityType i = 0; i < count; ++i)
+                Group.add(i);
+        }));
+        report("group_iterate", name, n, best([] {
+            total = 0;
+            corsac::System<Step>(Group);
+            sink = total;
+        }));
+        report("group_remove", name, n, measure([&] {
+            for (corsac::EntityType i = 0; i < count; ++i)
+                Group.remove(i);
+        }));
+    }
+
+    template<size_t N>
+    void run(size_t limit)
+    {
+        if (N > limit)
+            return;
+        entities(N);
+        storage<corsac::DYNAMIC, 0>("DYNAMIC", N);
+        storage<corsac::FIXED, N>("FIXED", N);
+        storage<corsac::STATIC, N>("STATIC", N);
+        group<Unit>("group", N);
+        group<OwnedUnit>("owning_group", N);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t limit = static_cast<size_t>(-1);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--json") == 0)
+            bench::json = true;
+        else
+            limit = static_cast<size_t>(std::strtoull(argv[i], nullptr, 10));
+    }
+
+    if (!bench::json)
+        std::printf("benchmark,storage,entities,ns,ns_per_entity\n");
+    bench::run<10000>(limit);
+    bench::run<1000000>(limit);
+    bench::run<10000000>(limit);
+    return 0;
+}
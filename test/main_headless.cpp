@@ -0,0 +1,40 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#define TEST_ENABLE
+#define CORSAC_DEBUG 1
+#define CORSAC_EXCEPTIONS_ENABLED 1
+
+#include "Test.h"
+
+void* operator new[](size_t size, const char*, int, unsigned, const char*, int)
+{
+    return new uint8_t[size];
+}
+
+void* operator new[](size_t size, size_t, size_t, const char*, int, unsigned, const char*, int)
+{
+    return new uint8_t[size];
+}
+
+#include "Corsac/ecs.h"
+
+#include "suites.h"
+
+/*
+ * ECS_Test_Headless
+ *
+ * Те же наборы, что и ECS_Test, без консольной демо-сцены (conio.h, windows.h):
+ * запускается CTest на любой платформе. Рабочий каталог - каталог сборки,
+ * там mapped_test создает и удаляет свои файлы. CORSAC_ECS_STATS задает цель
+ * (ECS_Test_Stats собирается со счетчиками). Block не отдает число провалов,
+ * поэтому CTest проверяет его отчет (FAIL_REGULAR_EXPRESSION в CMakeLists.txt).
+ */
+int main()
+{
+    auto assert = new corsac::Block("ECS");
+    ecs_test(assert);
+    assert->start();
+    return 0;
+}
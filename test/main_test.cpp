@@ -7,6 +7,7 @@
 #define TEST_ENABLE
 #define CORSAC_DEBUG 1
 #define CORSAC_EXCEPTIONS_ENABLED 1
+#define CORSAC_ECS_STATS 1
 
 #include "Test.h"
 
@@ -49,6 +50,8 @@ corsac::Group<Position, Direction, Speed> Transform;
 
 corsac::Group<Transform> Person;
 
+corsac::CommandBuffer Commands;
+
 void KeyEventSystem()
 {
     while(_kbhit()) {
@@ -75,8 +78,9 @@ void WMovebleEvent()
     for(auto start = W.begin(), end = W.end(); start < end; ++start)
     {
         if(Direction.has(*start))
-            corsac::Entity<>(*start).fit<Direction>(0, -1).remove<W>();
+            Commands.fit<Direction>(*start, 0, -1).remove<W>(*start);
     }
+    Commands.flush();
 }
 
 void SMovebleEvent()
@@ -84,8 +88,9 @@ void SMovebleEvent()
     for(auto start = S.begin(), end = S.end(); start < end; ++start)
     {
         if(Direction.has(*start))
-            corsac::Entity<>(*start).fit<Direction>(0, 1).remove<S>();
+            Commands.fit<Direction>(*start, 0, 1).remove<S>(*start);
     }
+    Commands.flush();
 }
 
 void AMovebleEvent()
@@ -93,8 +98,9 @@ void AMovebleEvent()
     for(auto start = A.begin(), end = A.end(); start < end; ++start)
     {
         if(Direction.has(*start))
-            corsac::Entity<>(*start).fit<Direction>(-1, 0).remove<A>();
+            Commands.fit<Direction>(*start, -1, 0).remove<A>(*start);
     }
+    Commands.flush();
 }
 
 void DMovebleEvent()
@@ -102,20 +108,19 @@ void DMovebleEvent()
     for(auto start = D.begin(), end = D.end(); start < end; ++start)
     {
         if(Direction.has(*start))
-            corsac::Entity<>(*start).fit<Direction>(1, 0).remove<D>();
+            Commands.fit<Direction>(*start, 1, 0).remove<D>(*start);
     }
+    Commands.flush();
 }
 
 void Move()
 {
-    for(auto start = Transform.begin(), end = Transform.end(); start < end; ++start)
+    for(auto [ent, x, y, dx, dy, speed] : corsac::View<Position, Direction, Speed>())
     {
-        corsac::Entity<Transform>(*start)
-                .set<Position>(
-                        Position.get<0>(*start) + (Direction.get<0>(*start) * Speed.get(*start)),
-                        Position.get<1>(*start) + (Direction.get<1>(*start) * Speed.get(*start))
-                )
-                .fit<Direction>(0, 0);
+        x += dx * speed;
+        y += dy * speed;
+        dx = 0;
+        dy = 0;
     }
 }
 
@@ -154,15 +159,13 @@ void Draw()
 
 #include "Test.h"
 
-#include "sparse_set_test.h"
+#include "suites.h"
 
 int main()
 {
     auto assert = new corsac::Block("ECS");
 
-    assert->add_block("sparse_set_test", [](corsac::Block *assert) {
-        sparse_set_test(assert);
-    });
+    ecs_test(assert);
 
     assert->start();
 
@@ -0,0 +1,191 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_MAPPED_TEST_H
+#define ECS_MAPPED_TEST_H
+
+#include "Corsac/mapped_vector.h"
+#include "Corsac/component.h"
+
+#include <cstdio>
+#include <string>
+
+#if CORSAC_ECS_MMAP_ENABLED
+    #include <unistd.h>
+#endif
+
+namespace mapped_test_data
+{
+    inline std::string read_file(const std::string& path)
+    {
+        std::string data;
+        if (std::FILE* file = std::fopen(path.c_str(), "rb"))
+        {
+            char buffer[4096];
+            for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) != 0;)
+                data.append(buffer, n);
+            std::fclose(file);
+        }
+        return data;
+    }
+
+    inline void write_file(const std::string& path, const std::string& data)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        std::fwrite(data.data(), 1, data.size(), file);
+        std::fclose(file);
+    }
+}
+
+bool mapped_test(corsac::Block* assert) {
+
+    assert->add_block("memory", [](corsac::Block *assert) {
+        corsac::Component<int, float>::Config<corsac::MAPPED> position;
+        corsac::Component<int>::Config<corsac::MAPPED> health;
+        for (corsac::EntityType i = 0; i < 5000; ++i)
+        {
+            position.add(i, static_cast<int>(i), 0.5f);
+            health.add(i, 100);
+        }
+        position.remove(7);
+        health.remove(7);
+        assert->equal("size()", position.size(), 4999);
+        assert->equal("swap with last", position.get<0>(4999), 4999);
+        assert->equal("AoS", health.get(4999), 100);
+        assert->is_false("removed", position.has(7) || health.has(7));
+    });
+    assert->add_block("persistent", [](corsac::Block *assert) {
+        const std::string path = "corsac_mapped_test";
+        const char* files[] = {".packed", ".0", ".1", ".hp.packed", ".hp.values"};
+        for (const char* file : files)
+            std::remove((path + file).c_str());
+
+        {
+            corsac::Component<int, float>::Config<corsac::MAPPED> position;
+            corsac::Component<int>::Config<corsac::MAPPED> health;
+            position.add(3, 30, 3.5f);
+            const bool opened = position.open(path.c_str()) & health.open((path + ".hp").c_str());
+            assert->equal("open()", opened, CORSAC_ECS_MMAP_ENABLED != 0);
+            assert->equal("kept on open", position.get<0>(3), 30);
+
+            for (corsac::EntityType i = 10; i < 3000; ++i)
+            {
+                position.add(i, static_cast<int>(i), 1.0f);
+                health.add(i, static_cast<int>(i) * 2);
+            }
+            position.remove(10);
+            health.remove(10);
+            position.sync();
+        }
+    #if CORSAC_ECS_MMAP_ENABLED
+        corsac::Component<int, float>::Config<corsac::MAPPED> position;
+        corsac::Component<int>::Config<corsac::MAPPED> health;
+        position.add(1, 1, 1.0f);
+        assert->is_true("reopen", position.open(path.c_str()) && health.open((path + ".hp").c_str()));
+        assert->equal("size()", position.size(), 2990);
+        assert->is_false("in-memory data replaced", position.has(1));
+        assert->equal("column 0", position.get<0>(2999), 2999);
+        assert->equal("column 1", position.get<1>(3), 3.5f);
+        assert->equal("AoS", health.get(1500), 3000);
+        assert->is_false("removed", position.has(10) || health.has(10));
+        assert->is_true("signature", position.signature_bit() != corsac::internal::registry_npos);
+
+        // Колонка, записанная не до конца, обрезает хранилище до общей длины.
+        {
+            corsac::internal::mapped_vector<float> column;
+            column.open((path + ".1").c_str());
+            column.pop_back();
+        }
+        corsac::Component<int, float>::Config<corsac::MAPPED> truncated;
+        truncated.open(path.c_str());
+        assert->equal("truncated", truncated.size(), 2989);
+
+        // Чужой файл не отображается.
+        corsac::internal::mapped_vector<double> foreign;
+        assert->is_false("foreign file", foreign.open((path + ".hp.values").c_str()));
+    #endif
+        for (const char* file : files)
+            std::remove((path + file).c_str());
+    });
+#if CORSAC_ECS_MMAP_ENABLED
+    assert->add_block("foreign", [](corsac::Block *assert) {
+        using namespace mapped_test_data;
+        const std::string path = "corsac_mapped_foreign";
+        const char* files[] = {".packed", ".values", ".soa.packed", ".soa.0", ".soa.1"};
+        for (const char* file : files)
+            std::remove((path + file).c_str());
+        {
+            corsac::Component<int>::Config<corsac::MAPPED> health;
+            corsac::Component<int, float>::Config<corsac::MAPPED> position;
+            health.open(path.c_str());
+            position.open((path + ".soa").c_str());
+            for (corsac::EntityType i = 0; i < 100; ++i)
+            {
+                health.add(i, static_cast<int>(i));
+                position.add(i, static_cast<int>(i), 1.0f);
+            }
+            health.sync();
+            position.sync();
+        }
+        const std::string packed = read_file(path + ".packed");
+        const std::string values = read_file(path + ".values");
+        const std::string column = read_file(path + ".soa.1");
+
+        // Чужой файл значений: open() отказывает, не тронув ни один из файлов.
+        write_file(path + ".values", "junk");
+        write_file(path + ".soa.1", "junk");
+        {
+            corsac::Component<int>::Config<corsac::MAPPED> health;
+            corsac::Component<int, float>::Config<corsac::MAPPED> position;
+            health.add(5, 50);
+            assert->is_false("AoS open()", health.open(path.c_str()));
+            assert->is_false("SoA open()", position.open((path + ".soa").c_str()));
+            assert->equal("kept in memory", health.get(5), 50);
+        }
+        assert->is_true("packed untouched", read_file(path + ".packed") == packed);
+        assert->is_true("values untouched", read_file(path + ".values") == "junk");
+
+        write_file(path + ".values", values);
+        write_file(path + ".soa.1", column);
+        corsac::Component<int>::Config<corsac::MAPPED> health;
+        corsac::Component<int, float>::Config<corsac::MAPPED> position;
+        assert->is_true("reopen", health.open(path.c_str()) && position.open((path + ".soa").c_str()));
+        assert->equal("AoS size()", health.size(), 100);
+        assert->equal("SoA size()", position.size(), 100);
+        assert->equal("value", health.get(99), 99);
+
+        // Файл значений не создается уже после отображения packed (ссылка в несуществующий
+        // каталог проходит проверку): хранилище возвращается к прежнему содержимому.
+        const std::string late = path + ".late";
+        const char* lateFiles[] = {".packed", ".values", ".soa.packed", ".soa.0", ".soa.1"};
+        for (const char* file : lateFiles)
+            std::remove((late + file).c_str());
+        write_file(late + ".packed", packed);
+        write_file(late + ".soa.packed", packed);
+        assert->equal("dangling links", ::symlink("corsac_mapped_missing/values", (late + ".values").c_str())
+                                        + ::symlink("corsac_mapped_missing/1", (late + ".soa.1").c_str()), 0);
+        {
+            corsac::Component<int>::Config<corsac::MAPPED> kept;
+            corsac::Component<int, float>::Config<corsac::MAPPED> keptSoA;
+            for (corsac::EntityType i = 0; i < 3; ++i)
+            {
+                kept.add(200 + i, static_cast<int>(i));
+                keptSoA.add(200 + i, static_cast<int>(i), 2.0f);
+            }
+            assert->is_false("AoS late open()", kept.open(late.c_str()));
+            assert->is_false("SoA late open()", keptSoA.open((late + ".soa").c_str()));
+            assert->is_true("AoS restored", kept.size() == 3 && kept.has(202) && kept.get(202) == 2 && !kept.has(0));
+            assert->is_true("SoA restored", keptSoA.size() == 3 && keptSoA.has(202) && keptSoA.get<0>(202) == 2 && !keptSoA.has(0));
+        }
+        assert->is_true("late packed untouched", read_file(late + ".packed") == packed);
+        for (const char* file : lateFiles)
+            std::remove((late + file).c_str());
+        for (const char* file : files)
+            std::remove((path + file).c_str());
+    });
+#endif
+    return true;
+}
+
+#endif //ECS_MAPPED_TEST_H
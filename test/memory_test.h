@@ -0,0 +1,144 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_MEMORY_TEST_H
+#define ECS_MEMORY_TEST_H
+
+#include "Corsac/memory.h"
+#include "Corsac/group.h"
+#include "Corsac/world.h"
+
+namespace memory_test_data
+{
+    struct Level {};
+    struct Menu {};
+
+    using LevelAllocator = corsac::ArenaAllocator<Level>;
+    using MenuAllocator  = corsac::PoolAllocator<Menu>;
+
+    inline corsac::Component<int, float>::Config<corsac::DYNAMIC, 0, MenuAllocator> Position;
+    inline corsac::Component<int>::Config<corsac::DYNAMIC, 0, MenuAllocator> Health;
+
+    inline corsac::Group<Position, Health>::Config<corsac::DYNAMIC, 0, false, MenuAllocator> Unit;
+
+    struct Mass : corsac::Component<float> {};
+    struct Velocity : corsac::Component<float, float> {};
+}
+
+bool memory_test(corsac::Block* assert) {
+
+    using namespace memory_test_data;
+
+    assert->add_block("arena", [](corsac::Block *assert) {
+        corsac::ArenaResource arena(1024);
+        auto* first = static_cast<uint8_t*>(arena.allocate(3, 1));
+        auto* aligned = static_cast<uint8_t*>(arena.allocate(8, 64));
+        assert->equal("alignment", reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+        assert->is_true("same block", aligned > first && aligned - first < 128);
+        arena.allocate(4096);
+        assert->equal("used()", arena.used(), 3 + 8 + 4096);
+        arena.release();
+        assert->equal("release()", arena.reserved(), 0);
+    });
+    assert->add_block("pool", [](corsac::Block *assert) {
+        corsac::PoolResource pool(1024);
+        void* block = pool.allocate(100);
+        pool.deallocate(block, 100);
+        assert->is_true("same class reused", pool.allocate(120) == block);
+        assert->is_true("other class", pool.allocate(20) != block);
+        void* large = pool.allocate(CORSAC_ECS_POOL_MAX_CLASS * 2);
+        pool.deallocate(large, CORSAC_ECS_POOL_MAX_CLASS * 2);
+        assert->is_true("large not pooled", pool.allocate(CORSAC_ECS_POOL_MAX_CLASS * 2) != large);
+    });
+    assert->add_block("scene", [](corsac::Block *assert) {
+        auto& arena = LevelAllocator::resource();
+        corsac::Component<int, float>::Config<corsac::DYNAMIC, 0, LevelAllocator> position;
+        corsac::Component<int>::Config<corsac::DYNAMIC, 0, LevelAllocator> health;
+        corsac::Component<>::Config<corsac::DYNAMIC, 0, LevelAllocator> alive;
+        health.track_changes();
+        for (corsac::EntityType i = 0; i < 5000; ++i)
+        {
+            position.add(i, static_cast<int>(i), 0.5f);
+            health.add(i, 100);
+            alive.add(i);
+        }
+        health.remove(3);
+        assert->equal("values", position.get<0>(4999), 4999);
+        assert->equal("AoS", health.get(4999), 100);
+        assert->is_true("from arena", arena.used() > 5000 * (sizeof(int) * 3 + sizeof(float)));
+
+        // Сцена сбрасывается без обхода элементов: хранилища забывают память, арена отдает блоки.
+        position.reset_lose_memory();
+        health.reset_lose_memory();
+        alive.reset_lose_memory();
+        arena.release();
+        assert->is_true("empty", position.empty() && health.empty() && alive.empty());
+        assert->is_false("sparse dropped", alive.has(10));
+        const corsac::internal::signature bits = corsac::internal::getRegistry().of(10);
+        assert->is_false("registry bits dropped", bits.test(position.signature_bit()) || bits.test(alive.signature_bit()));
+
+        position.add(7, 1, 2.0f);
+        health.add(7, 3);
+        assert->equal("reused", position.get<1>(7) + static_cast<float>(health.get(7)), 5.0f);
+        assert->is_true("new block", arena.reserved() > 0);
+    });
+    assert->add_block("group", [](corsac::Block *assert) {
+        corsac::Entity<Unit> first;
+        corsac::Entity<Unit> second;
+        first.fit<Position>(1, 1.0f).fit<Health>(10);
+        second.fit<Position>(2, 2.0f).fit<Health>(20);
+        assert->equal("size()", Unit.size(), 2);
+        assert->is_true("pool used", MenuAllocator::resource().reserved() > 0);
+        first.destroy();
+        assert->is_false("destroyed", Unit.has(first.id()) || Position.has(first.id()));
+        assert->equal("value", second.get<Health>(), 20);
+        second.destroy();
+    });
+    assert->add_block("usage", [](corsac::Block *assert) {
+        corsac::Component<int, float> position;
+        corsac::Component<int> health;
+        position.add(0, 1, 1.0f);
+        position.add(9999, 2, 2.0f);
+        health.add(5, 3);
+
+        const corsac::MemoryUsage usage = position.memory_usage();
+        assert->equal("entities", usage.entities, 2);
+        assert->equal("max_id", usage.max_id, 10000);
+        assert->equal("packed", usage.packed_used, 2 * sizeof(corsac::EntityType));
+        assert->equal("values SoA", usage.values_used, 2 * (sizeof(int) + sizeof(float)));
+        assert->equal("values AoS", health.memory_usage().values_used, sizeof(int));
+        // Два ID на разных страницах: заняты две страницы из трех адресуемых.
+        assert->is_true("sparse pages", usage.sparse_capacity >= 2 * CORSAC_ECS_SPARSE_PAGE_SIZE * sizeof(corsac::EntityType)
+                                        && usage.sparse_capacity < 3 * CORSAC_ECS_SPARSE_PAGE_SIZE * sizeof(corsac::EntityType));
+        assert->is_true("used <= capacity", usage.used() <= usage.capacity());
+        assert->equal("density", usage.density(), 2.0 / 10000.0);
+
+        health.track_changes();
+        assert->equal("ticks", health.memory_usage().other_used, 2 * sizeof(corsac::Tick));
+
+        corsac::MemoryUsage total = position.memory_usage();
+        total += health.memory_usage();
+        assert->equal("sum", total.entities, 3);
+        assert->equal("sum max_id", total.max_id, 10000);
+    });
+    assert->add_block("world usage", [](corsac::Block *assert) {
+        corsac::World<Mass, Velocity> world;
+        assert->equal("empty", world.memory_usage().used(), 0);
+        for (int i = 0; i < 4; ++i)
+            world.create().add<Mass>(1.0f).add<Velocity>(0.0f, 0.0f);
+        world.destroy(world.get(0).id());
+
+        const corsac::MemoryUsage usage = world.memory_usage();
+        assert->equal("entities", usage.entities, 3);
+        assert->equal("max_id", usage.max_id, 4);
+        assert->equal("values", usage.values_used, 3 * sizeof(float) * 3);
+        assert->is_true("slots and signatures", usage.other_used >= 4 * sizeof(corsac::EntityType));
+
+        const corsac::MemoryUsage global = corsac::memory_usage<Position, Health, Unit>();
+        assert->is_true("global", global.capacity() >= global.used());
+    });
+    return true;
+}
+
+#endif //ECS_MEMORY_TEST_H
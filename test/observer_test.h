@@ -0,0 +1,91 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_OBSERVER_TEST_H
+#define ECS_OBSERVER_TEST_H
+
+#include "Corsac/observer.h"
+#include "Corsac/command_buffer.h"
+
+namespace observer_test_data
+{
+    inline corsac::Observed<corsac::Component<int, int>> Position;
+    inline corsac::Observed<corsac::Component<int>> Health;
+
+    inline corsac::Observed<corsac::Group<Position, Health>> Unit;
+}
+
+bool observer_test(corsac::Block* assert) {
+
+    using namespace observer_test_data;
+
+    assert->add_block("signals", [](corsac::Block *assert) {
+        size_t added = 0;
+        size_t updated = 0;
+        int removedValue = 0;
+        Position.on_add().connect([&added](const corsac::EntityType*, size_t n) { added += n; });
+        Position.on_update().connect([&updated](const corsac::EntityType*, size_t n) { updated += n; });
+        Position.on_remove().connect([&removedValue](const corsac::EntityType* ids, size_t) {
+            removedValue = Position.get<0>(ids[0]);
+        });
+
+        Position.add(1, 5, 5);
+        Position.add(1, 6, 6);
+        Position.set(1, 7, 7);
+        Position.fit(1, 8, 8);
+        Position.set(2, 1, 1);
+        assert->equal("on_add", added, 2);
+        assert->equal("on_update", updated, 2);
+
+        Position.remove(1);
+        assert->equal("on_remove before remove", removedValue, 8);
+
+        size_t unitAdded = 0;
+        const size_t listener = Unit.on_add().connect([&unitAdded](const corsac::EntityType*, size_t n) { unitAdded += n; });
+        corsac::Entity<Unit> ent;
+        assert->equal("group on_add", unitAdded, 1);
+        assert->equal("member on_add", added, 3);
+        ent.destroy();
+
+        Unit.on_add().disconnect(listener);
+        corsac::Entity<Unit>().destroy();
+        assert->equal("disconnect()", unitAdded, 1);
+
+        Position.on_add().clear();
+        Position.on_update().clear();
+        Position.on_remove().clear();
+        Position.remove(2);
+    });
+
+    assert->add_block("batch", [](corsac::Block *assert) {
+        size_t batches = 0;
+        size_t added = 0;
+        Health.on_add().connect([&batches, &added](const corsac::EntityType*, size_t n) {
+            ++batches;
+            added += n;
+        });
+
+        const corsac::EntityType ids[] = {100, 101, 102, 103};
+        const int values[] = {1, 2, 3, 4};
+        Health.add(101, 0);
+        Health.add_n(ids, 4, values);
+        assert->equal("add_n batches", batches, 2);
+        assert->equal("add_n added", added, 4);
+
+        corsac::CommandBuffer commands;
+        for (corsac::EntityType i = 200; i < 210; ++i)
+            commands.add<Health>(i, 1);
+        commands.flush();
+        assert->equal("flush batches", batches, 3);
+        assert->equal("flush added", added, 14);
+
+        Health.on_add().clear();
+        for (corsac::EntityType i = 100; i < 210; ++i)
+            Health.remove(i);
+    });
+
+    return true;
+}
+
+#endif //ECS_OBSERVER_TEST_H
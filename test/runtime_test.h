@@ -0,0 +1,71 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_RUNTIME_TEST_H
+#define ECS_RUNTIME_TEST_H
+
+#include "Corsac/runtime.h"
+#include "Corsac/world.h"
+
+#include <chrono>
+#include <thread>
+
+namespace runtime_test_data
+{
+    struct Position : corsac::Component<int> {};
+
+    using Match = corsac::World<Position>;
+}
+
+bool runtime_test(corsac::Block* assert) {
+
+    using namespace runtime_test_data;
+
+    assert->add_block("step", [](corsac::Block *assert) {
+        corsac::ThreadPool pool(3);
+        corsac::Runtime<Match> runtime(pool);
+        for (int w = 0; w < 8; ++w)
+        {
+            const size_t index = runtime.add([](Match& match) {
+                match.view<Position>().each([](corsac::EntityType, int& x) { ++x; });
+            });
+            for (int i = 0; i < 100; ++i)
+                runtime.world(index).create().add<Position>(w);
+        }
+        for (int frame = 0; frame < 5; ++frame)
+            runtime.step();
+
+        bool stepped = true;
+        for (size_t w = 0; w < runtime.size(); ++w)
+        {
+            const int expected = static_cast<int>(w) + 5;
+            stepped &= runtime.world(w).get(99).get<Position>() == expected;
+            stepped &= runtime.world(w).current_tick() == 6 && runtime.stats(w).frames == 5;
+        }
+        assert->is_true("all worlds stepped", stepped);
+        assert->is_true("worker", runtime.stats(0).worker <= pool.size());
+    });
+    assert->add_block("budget", [](corsac::Block *assert) {
+        corsac::ThreadPool pool(2);
+        corsac::Runtime<Match> runtime(pool);
+        const auto budget = std::chrono::milliseconds(1);
+        runtime.add([](Match&) {}, budget);
+        const size_t slow = runtime.add([](Match&) { std::this_thread::sleep_for(std::chrono::milliseconds(3)); }, budget);
+        runtime.add([](Match&) {});
+
+        runtime.run(3, std::chrono::milliseconds(1));
+        assert->equal("overruns", runtime.stats(slow).overruns, 3);
+        assert->equal("in budget", runtime.stats(0).overruns, 0);
+        assert->equal("frame_overruns()", runtime.frame_overruns(), 1);
+        assert->is_true("max", runtime.stats(slow).max >= 3000000 && runtime.stats(slow).average() >= 3000000);
+        assert->is_true("frame_time()", runtime.frame_time() >= runtime.stats(slow).last);
+
+        runtime.reset_stats();
+        assert->equal("reset_stats()", runtime.stats(slow).frames, 0);
+        assert->equal("budget kept", runtime.stats(slow).budget, 1000000);
+    });
+    return true;
+}
+
+#endif //ECS_RUNTIME_TEST_H
@@ -0,0 +1,141 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_SCHEDULER_TEST_H
+#define ECS_SCHEDULER_TEST_H
+
+#include "Corsac/scheduler.h"
+#include "Corsac/component.h"
+#include "Corsac/group.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace scheduler_test_data
+{
+    inline corsac::Component<int> Position;
+    inline corsac::Component<int> Direction;
+    inline corsac::Component<int> Speed;
+    inline corsac::Component<int> Armor;
+    inline corsac::Component<int> Shield;
+    inline corsac::Component<int> Mass;
+    inline corsac::Component<int> Volume;
+
+    inline corsac::Group<Mass, Volume> Body;
+    inline corsac::Group<Body, Speed> Heavy;
+}
+
+bool scheduler_test(corsac::Block* assert) {
+
+    using namespace scheduler_test_data;
+    using corsac::Reads;
+    using corsac::Writes;
+
+    assert->add_block("conflicts", [](corsac::Block *assert) {
+        corsac::Scheduler scheduler;
+        const size_t move   = scheduler.add<Reads<Direction, Speed>, Writes<Position>>([] {});
+        const size_t render = scheduler.add<Reads<Position>, Writes<>>([] {});
+        const size_t steer  = scheduler.add<Reads<Speed>, Writes<Direction>>([] {});
+        const size_t speed  = scheduler.add<Reads<>, Writes<Speed>>([] {});
+        const size_t look   = scheduler.add<Reads<Speed>, Writes<>>([] {});
+
+        assert->is_true("write -> read", scheduler.depends(render, move));
+        assert->is_true("read -> write", scheduler.depends(steer, move));
+        assert->is_true("write -> write", scheduler.depends(speed, move) && scheduler.depends(speed, steer));
+        assert->is_false("read -> read", scheduler.depends(look, move) || scheduler.depends(look, steer));
+        assert->is_false("disjoint", scheduler.depends(steer, render));
+        assert->is_true("after write", scheduler.depends(look, speed));
+    });
+    assert->add_block("groups", [](corsac::Block *assert) {
+        corsac::Scheduler scheduler;
+        const size_t body   = scheduler.add<Reads<>, Writes<Body>>([] {});
+        const size_t mass   = scheduler.add<Reads<Mass>, Writes<>>([] {});
+        const size_t volume = scheduler.add<Reads<>, Writes<Volume>>([] {});
+        const size_t heavy  = scheduler.add<Reads<Heavy>, Writes<>>([] {});
+        const size_t look   = scheduler.add<Reads<Body>, Writes<>>([] {});
+
+        assert->is_true("group -> member", scheduler.depends(mass, body));
+        assert->is_true("member -> nested group", scheduler.depends(heavy, volume));
+        assert->is_false("read group, read member", scheduler.depends(look, mass) || scheduler.depends(look, heavy));
+        assert->is_true("read group after write member", scheduler.depends(look, volume));
+    });
+    assert->add_block("deterministic", [](corsac::Block *assert) {
+        corsac::ThreadPool pool(4);
+        corsac::Scheduler scheduler;
+        corsac::vector<int> order;
+        for (int i = 0; i < 6; ++i)
+            scheduler.add<Reads<Speed>, Writes<>>([&order, i] { order.push_back(i); });
+
+        scheduler.run(pool, corsac::DETERMINISTIC);
+        bool ordered = order.size() == 6;
+        for (size_t i = 0; ordered && i < order.size(); ++i)
+            ordered = order[i] == static_cast<int>(i);
+        assert->is_true("insertion order", ordered);
+    });
+    assert->add_block("parallel", [](corsac::Block *assert) {
+        corsac::ThreadPool pool(4);
+        std::atomic<int> independent{0};
+        int written = 0;
+        bool orderKept = true;
+
+        // Новый планировщик на каждый прогон: состояние run() не должно переживать его.
+        for (int run = 0; run < 2000; ++run)
+        {
+            corsac::Scheduler scheduler;
+            scheduler.add<Reads<>, Writes<Position>>([&written, run] { written = run; });
+            scheduler.add<Reads<Position>, Writes<>>([&written, &orderKept, run] { orderKept &= written == run; });
+            scheduler.add<Reads<Speed>, Writes<>>([&independent] { ++independent; });
+            scheduler.add<Reads<Speed>, Writes<>>([&independent] { ++independent; });
+            scheduler.run(pool);
+        }
+        assert->is_true("dependency order", orderKept);
+        assert->equal("all completed", independent.load(), 4000);
+    });
+    assert->add_block("same pool", [](corsac::Block *assert) {
+        // run() из задачи пула с одним потоком: системы выполняет сам этот поток.
+        corsac::ThreadPool pool(1);
+        corsac::Scheduler scheduler;
+        std::atomic<int> completed{0};
+        scheduler.add<Reads<>, Writes<Position>>([&completed] { ++completed; });
+        scheduler.add<Reads<Position>, Writes<>>([&completed] { ++completed; });
+        scheduler.add<Reads<Speed>, Writes<>>([&completed] { ++completed; });
+        pool.submit([&scheduler, &pool] { scheduler.run(pool); });
+        pool.wait();
+        assert->equal("completed", completed.load(), 3);
+    });
+    assert->add_block("disjoint writers", [](corsac::Block *assert) {
+        constexpr size_t count = 20000;
+        corsac::ThreadPool pool(2);
+        corsac::vector<corsac::EntityType> ids;
+        for (size_t i = 0; i < count; ++i)
+            ids.push_back(corsac::internal::getNewEntityTypeID());
+
+        // Системы пишут разные хранилища, но отмечают одни и те же сигнатуры.
+        corsac::Scheduler scheduler;
+        scheduler.add<Reads<>, Writes<Armor>>([&ids] { for (const auto id : ids) Armor.add(id, 1); });
+        scheduler.add<Reads<>, Writes<Shield>>([&ids] { for (const auto id : ids) Shield.add(id, 2); });
+        assert->is_false("independent", scheduler.depends(1, 0));
+        scheduler.run(pool);
+
+        bool both = true;
+        for (const auto id : ids)
+            both = both && corsac::Entity<>(id).has<Armor, Shield>();
+        assert->is_true("both bits", both);
+
+        corsac::Scheduler removal;
+        removal.add<Reads<>, Writes<Armor>>([&ids] { for (const auto id : ids) Armor.remove(id); });
+        removal.add<Reads<>, Writes<Shield>>([&ids] { for (const auto id : ids) Shield.remove(id); });
+        removal.run(pool);
+
+        bool none = true;
+        for (const auto id : ids)
+            none = none && !corsac::Entity<>(id).has<Armor>() && !corsac::Entity<>(id).has<Shield>();
+        assert->is_true("bits cleared", none);
+        for (const auto id : ids)
+            corsac::internal::getEntityAllocator().destroy(id);
+    });
+    return true;
+}
+
+#endif //ECS_SCHEDULER_TEST_H
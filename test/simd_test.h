@@ -0,0 +1,68 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_SIMD_TEST_H
+#define ECS_SIMD_TEST_H
+
+#include "Corsac/simd.h"
+#include "Corsac/component.h"
+
+bool simd_test(corsac::Block* assert) {
+
+    assert->add_block("kernels", [](corsac::Block *assert) {
+        const corsac::SimdLevel supported = corsac::simd_level();
+        const corsac::SimdLevel levels[] = {corsac::SIMD_SCALAR, corsac::SIMD_SSE42, corsac::SIMD_AVX2};
+        for (corsac::SimdLevel level : levels)
+        {
+            corsac::set_simd_level(level);
+
+            // 21 элемент: полные регистры SSE и AVX плюс хвост.
+            corsac::Component<int, int> position;
+            corsac::Component<int> speed;
+            for (corsac::EntityType i = 0; i < 21; ++i)
+            {
+                position.add(i, static_cast<int>(i), 1);
+                speed.add(i, 2);
+            }
+            corsac::simd::mul_add(position.get<0>(), position.get<1>(), speed.data(), position.size());
+            corsac::simd::scale(position.get<1>(), 3, position.size());
+            assert->equal("mul_add", position.get<0>(20), 22);
+            assert->equal("mul_add head", position.get<0>(0), 2);
+            assert->equal("scale tail", position.get<1>(20), 3);
+
+            float x[11] = {};
+            const float dx[11] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+            corsac::simd::fill(x, 0.5f, 11);
+            corsac::simd::add(x, dx, 11);
+            corsac::simd::mul(x, dx, 11);
+            assert->equal("float tail", x[10], 11.5f * 11.0f);
+        }
+        corsac::set_simd_level(supported);
+        assert->equal("restored", corsac::simd_level(), supported);
+    });
+    assert->add_block("aligned", [](corsac::Block *assert) {
+        corsac::Component<float, float>::Config<corsac::ALIGNED> position;
+        corsac::Component<float>::Config<corsac::ALIGNED> speed;
+        for (corsac::EntityType i = 0; i < 21; ++i)
+        {
+            position.add(i, 1.0f, 2.0f);
+            speed.add(i, 3.0f);
+        }
+        position.remove(20);
+        speed.remove(20);
+
+        const auto address = reinterpret_cast<uintptr_t>(position.get<1>());
+        assert->equal("column aligned", address % CORSAC_ECS_COLUMN_ALIGNMENT, 0);
+        assert->equal("padded_size()", position.padded_size(), 32);
+        assert->equal("padding zeroed", position.get<0>()[20], 0.0f);
+
+        // Полные регистры без хвоста, паддинг остается нулевым.
+        corsac::simd::mul_add(position.get<0>(), position.get<1>(), speed.data(), position.padded_size());
+        assert->equal("value", position.get<0>(7), 7.0f);
+        assert->equal("padding kept", position.get<0>()[31], 0.0f);
+    });
+    return true;
+}
+
+#endif //ECS_SIMD_TEST_H
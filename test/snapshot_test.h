@@ -0,0 +1,94 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_SNAPSHOT_TEST_H
+#define ECS_SNAPSHOT_TEST_H
+
+#include "Corsac/snapshot.h"
+#include "Corsac/group.h"
+
+namespace snapshot_test_data
+{
+    inline corsac::Component<int, float> Position;
+    inline corsac::Component<int> Health;
+    inline corsac::Component<> Alive;
+
+    inline corsac::OwningGroup<Position, Health> Unit;
+}
+
+bool snapshot_test(corsac::Block* assert) {
+
+    using namespace snapshot_test_data;
+
+    assert->add_block("storages", [](corsac::Block *assert) {
+        const corsac::EntityType ids[] = {7, 3, 70000, 12};
+        const int xs[] = {1, 2, 3, 4};
+        const float ys[] = {0.5f, 1.5f, 2.5f, 3.5f};
+
+        corsac::Component<int, float> position;
+        corsac::Component<int> health;
+        corsac::Component<> tag;
+        position.add_n(ids, 4, xs, ys);
+        health.add_n(ids, 4, xs);
+        tag.add_n(ids, 3);
+
+        corsac::Snapshot state;
+        position.snapshot(state);
+        health.snapshot(state);
+        tag.snapshot(state);
+
+        corsac::Component<int, float> position2;
+        corsac::Component<int> health2;
+        corsac::Component<> tag2;
+        position2.add(5, 9, 9.0f);
+        assert->is_true("restore SoA", position2.restore(state));
+        assert->is_true("restore AoS", health2.restore(state));
+        assert->is_true("restore set", tag2.restore(state));
+        assert->equal("remaining()", state.remaining(), 0);
+
+        assert->equal("size()", position2.size(), 4);
+        assert->is_false("old entity dropped", position2.has(5));
+        assert->equal("column 0", position2.get<0>(70000), 3);
+        assert->equal("column 1", position2.get<1>(12), 3.5f);
+        assert->equal("same order", position2.entities()[1], 3);
+        assert->equal("AoS value", health2.get(7), 1);
+        assert->is_true("sparse rebuilt", tag2.has(70000) && !tag2.has(12));
+
+        // Блок другой раскладки не читается.
+        state.rewind();
+        bool rejected = false;
+        try { rejected = !health2.restore(state); }
+        catch (const std::invalid_argument&) { rejected = true; }
+        assert->is_true("layout checked", rejected);
+    });
+    assert->add_block("world", [](corsac::Block *assert) {
+        corsac::Entity<Unit> first;
+        corsac::Entity<Unit> second;
+        corsac::Entity<Unit> third;
+        first.fit<Position>(10, 1.0f).fit<Health>(100);
+        second.fit<Position>(20, 2.0f).add<Alive>();
+        third.destroy();
+
+        corsac::Snapshot state;
+        corsac::snapshot<Position, Health, Alive, Unit>(state);
+        const size_t alive = corsac::internal::getEntityAllocator().alive();
+
+        corsac::Entity<Unit> extra;
+        first.fit<Health>(1);
+        second.destroy();
+
+        state.rewind();
+        assert->is_true("restore()", corsac::restore<Position, Health, Alive, Unit>(state));
+        assert->equal("allocator", corsac::internal::getEntityAllocator().alive(), alive);
+        assert->is_true("valid()", second.valid());
+        assert->is_false("created after snapshot", extra.valid() || Unit.has(extra.id()));
+        assert->equal("value", first.get<Health>(), 100);
+        assert->is_true("group", Unit.has(second.id()) && Alive.has(second.id()));
+        assert->is_true("signature", second.has<Position, Alive>());
+        assert->equal("owning prefix", Position.entities()[Unit.index(second.id())], second.id());
+    });
+    return true;
+}
+
+#endif //ECS_SNAPSHOT_TEST_H
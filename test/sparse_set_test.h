@@ -6,6 +6,7 @@
 #define ECS_SPARSE_SET_TEST_H
 
 #include "Corsac/sparse_set.h"
+#include "Corsac/component.h"
 
 bool sparse_set_test(corsac::Block* assert) {
 
@@ -85,6 +86,88 @@ bool sparse_set_test(corsac::Block* assert) {
         assert->equal("capacity()", set.capacity(), 10);
         assert->equal("max_size()", set.max_size(), 10);
     });
+    assert->add_block("paged sparse", [](corsac::Block *assert) {
+        corsac::sparse_set<uint32_t, 0, true, 64> set;
+        assert->is_false("has(element) without page", set.has(5000000));
+        set.add(5000000);
+        set.add(3);
+        assert->is_true("has(element)", set.has(5000000));
+        assert->is_true("has(element)", set.has(3));
+        assert->is_false("has(neighbour)", set.has(4999999));
+        assert->is_false("has(other page)", set.has(70));
+        assert->equal("size()", set.size(), 2);
+        set.remove(5000000);
+        assert->is_false("has(removed)", set.has(5000000));
+        set.shrink_to_fit();
+        assert->is_true("has(element) after shrink", set.has(3));
+        assert->is_false("has(removed) after shrink", set.has(5000000));
+    });
+    assert->add_block("add_n", [](corsac::Block *assert) {
+        const corsac::EntityType ids[] = {4, 9, 2, 9, 7};
+        const int xs[] = {40, 90, 20, 91, 70};
+        const int ys[] = {41, 92, 21, 93, 71};
+
+        corsac::sparse_set<corsac::EntityType> set;
+        set.add(2);
+        assert->equal("added", set.add_n(ids, 5), 3);
+        assert->equal("size()", set.size(), 4);
+
+        corsac::Component<int, int> position;
+        assert->equal("added all", position.add_n(ids, 3, xs, ys), 3);
+        assert->equal("column 0", position.get<0>(9), 90);
+        assert->equal("column 1", position.get<1>(2), 21);
+
+        corsac::Component<int> speed;
+        speed.add(2, 5);
+        assert->equal("duplicates skipped", speed.add_n(ids, 5, xs), 3);
+        assert->equal("first value kept", speed.get(9), 90);
+        assert->equal("existing kept", speed.get(2), 5);
+        assert->equal("value follows entity", speed.get(7), 70);
+    });
+    assert->add_block("sort", [](corsac::Block *assert) {
+        const corsac::EntityType ids[] = {8, 3, 6, 1, 9, 4, 0, 7};
+
+        corsac::sparse_set<corsac::EntityType> set;
+        set.add_n(ids, 8);
+        set.sort([](corsac::EntityType lhs, corsac::EntityType rhs) { return lhs < rhs; });
+        bool ordered = true;
+        for (corsac::EntityType i = 1; i < 8; ++i)
+            ordered = ordered && set.data()[i - 1] < set.data()[i] && set.index(set.data()[i]) == i;
+        assert->is_true("sort()", ordered);
+
+        corsac::Component<int> health;
+        corsac::Component<int, int> position;
+        for (corsac::EntityType id : ids)
+        {
+            health.add(id, 100 - static_cast<int>(id) * 30);
+            position.add(id, static_cast<int>(id), static_cast<int>(id % 3));
+        }
+        health.sort([](int lhs, int rhs) { return lhs < rhs; });
+        assert->equal("values sorted", health.data()[0], 100 - 9 * 30);
+        assert->equal("sparse fixed", health.get(9), 100 - 9 * 30);
+        assert->equal("entity follows value", health.entities()[7], 0);
+
+        // Устойчивая поразрядная сортировка: внутри ключа сохраняется прежний порядок.
+        position.sort_by_key([](int, int y) { return y; });
+        assert->equal("radix first", position.entities()[0], 3);
+        assert->equal("radix stable", position.entities()[1], 6);
+        assert->equal("radix last", position.entities()[7], 8);
+        assert->equal("radix values", position.get<0>(4), 4);
+
+        health.sort_by_key([](int value) { return value; });
+        assert->equal("signed key", health.entities()[0], 9);
+
+        position.remove(8);
+        position.sort_as(health);
+        bool same = true;
+        for (size_t i = 0, j = 0; i < health.size(); ++i)
+        {
+            if (position.has(health.entities()[i]))
+                same = same && position.entities()[j++] == health.entities()[i];
+        }
+        assert->is_true("sort_as()", same);
+        assert->equal("sort_as values", position.get<1>(7), 1);
+    });
     return true;
 }
 
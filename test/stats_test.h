@@ -0,0 +1,88 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_STATS_TEST_H
+#define ECS_STATS_TEST_H
+
+#include "Corsac/stats.h"
+#include "Corsac/system.h"
+
+#include <cstdio>
+#include <string>
+
+namespace stats_test_data
+{
+    inline std::string dump()
+    {
+        std::FILE* file = std::tmpfile();
+        corsac::dump_stats(file);
+        std::string text(static_cast<size_t>(std::ftell(file)), '\0');
+        std::rewind(file);
+        const size_t read = std::fread(&text[0], 1, text.size(), file);
+        std::fclose(file);
+        text.resize(read);
+        return text;
+    }
+
+    inline int loop(int n)
+    {
+        CORSAC_ECS_STATS_SCOPE("stats_test_loop");
+        int sum = 0;
+        for (int i = 0; i < n; ++i)
+            sum += i;
+        return sum;
+    }
+}
+
+bool stats_test(corsac::Block* assert) {
+
+    using namespace stats_test_data;
+
+#if CORSAC_ECS_STATS
+    assert->add_block("counters", [](corsac::Block *assert) {
+        corsac::Component<int, float> position;
+        CORSAC_ECS_STATS_NAME(position, "stats_test_position");
+        for (corsac::EntityType i = 0; i < 10000; ++i)
+            position.add(i, static_cast<int>(i), 0.5f);
+        auto& stats = position.statistics();
+        assert->equal("adds", stats.adds.load(), 10000);
+        assert->equal("sparse resizes", stats.sparse_resizes.load(), (10000 + CORSAC_ECS_SPARSE_PAGE_SIZE - 1) / CORSAC_ECS_SPARSE_PAGE_SIZE);
+        assert->is_true("reallocations", stats.reallocations.load() > 0);
+
+        const uint64_t moved = stats.bytes_moved.load();
+        position.remove(9999);
+        position.remove(0);
+        assert->equal("removes", stats.removes.load(), 2);
+        assert->equal("swap and pop", stats.bytes_moved.load() - moved, sizeof(corsac::EntityType) + sizeof(int) + sizeof(float));
+
+        corsac::System(position, [](corsac::EntityType, int&, float&) {});
+        assert->equal("iterate", stats.iterate.samples(), 1);
+
+        auto copy = position;
+        assert->equal("copy starts empty", copy.statistics().adds.load(), 0);
+    });
+    assert->add_block("dump", [](corsac::Block *assert) {
+        corsac::Component<int> health;
+        CORSAC_ECS_STATS_NAME(health, "stats_test_health");
+        health.add(1, 10);
+        loop(10);
+        loop(20);
+        const std::string text = dump();
+        assert->is_true("storage", text.find("corsac_ecs_adds_total{storage=\"stats_test_health\"} 1\n") != std::string::npos);
+        assert->is_true("loop", text.find("corsac_ecs_loop_ns_count{loop=\"stats_test_loop\"} 2\n") != std::string::npos);
+        assert->is_true("buckets", text.find("corsac_ecs_loop_ns_bucket{loop=\"stats_test_loop\",le=\"+Inf\"} 2\n") != std::string::npos);
+    });
+#else
+    assert->add_block("disabled", [](corsac::Block *assert) {
+        corsac::Component<int> health;
+        CORSAC_ECS_STATS_NAME(health, "stats_test_health");
+        health.add(1, 10);
+        assert->equal("loop", loop(4), 6);
+        assert->is_true("dump", dump().empty());
+    });
+#endif
+    return true;
+}
+
+#endif //ECS_STATS_TEST_H
@@ -0,0 +1,93 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_SUITES_H
+#define ECS_SUITES_H
+
+#include "sparse_set_test.h"
+#include "entity_test.h"
+#include "view_test.h"
+#include "group_test.h"
+#include "scheduler_test.h"
+#include "command_buffer_test.h"
+#include "simd_test.h"
+#include "archetype_test.h"
+#include "observer_test.h"
+#include "snapshot_test.h"
+#include "delta_test.h"
+#include "mapped_test.h"
+#include "memory_test.h"
+#include "world_test.h"
+#include "runtime_test.h"
+#include "stats_test.h"
+
+// Все наборы тестов ECS, общие для ECS_Test и ECS_Test_Headless.
+inline void ecs_test(corsac::Block* assert)
+{
+    assert->add_block("sparse_set_test", [](corsac::Block *assert) {
+        sparse_set_test(assert);
+    });
+
+    assert->add_block("entity_test", [](corsac::Block *assert) {
+        entity_test(assert);
+    });
+
+    assert->add_block("view_test", [](corsac::Block *assert) {
+        view_test(assert);
+    });
+
+    assert->add_block("group_test", [](corsac::Block *assert) {
+        group_test(assert);
+    });
+
+    assert->add_block("scheduler_test", [](corsac::Block *assert) {
+        scheduler_test(assert);
+    });
+
+    assert->add_block("command_buffer_test", [](corsac::Block *assert) {
+        command_buffer_test(assert);
+    });
+
+    assert->add_block("simd_test", [](corsac::Block *assert) {
+        simd_test(assert);
+    });
+
+    assert->add_block("archetype_test", [](corsac::Block *assert) {
+        archetype_test(assert);
+    });
+
+    assert->add_block("observer_test", [](corsac::Block *assert) {
+        observer_test(assert);
+    });
+
+    assert->add_block("snapshot_test", [](corsac::Block *assert) {
+        snapshot_test(assert);
+    });
+
+    assert->add_block("delta_test", [](corsac::Block *assert) {
+        delta_test(assert);
+    });
+
+    assert->add_block("mapped_test", [](corsac::Block *assert) {
+        mapped_test(assert);
+    });
+
+    assert->add_block("memory_test", [](corsac::Block *assert) {
+        memory_test(assert);
+    });
+
+    assert->add_block("world_test", [](corsac::Block *assert) {
+        world_test(assert);
+    });
+
+    assert->add_block("runtime_test", [](corsac::Block *assert) {
+        runtime_test(assert);
+    });
+
+    assert->add_block("stats_test", [](corsac::Block *assert) {
+        stats_test(assert);
+    });
+}
+
+#endif //ECS_SUITES_H
@@ -0,0 +1,102 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_VIEW_TEST_H
+#define ECS_VIEW_TEST_H
+
+#include "Corsac/view.h"
+
+bool view_test(corsac::Block* assert) {
+
+    assert->add_block("join", [](corsac::Block *assert) {
+        corsac::Component<int, int> position;
+        corsac::Component<int> speed;
+        corsac::Component<> tag;
+
+        for (corsac::EntityType i = 0; i < 10; ++i)
+            position.add(i, static_cast<int>(i), 0);
+        speed.add(3, 2);
+        speed.add(7, 5);
+        speed.add(20, 1);
+        tag.add(3);
+        tag.add(7);
+        tag.add(9);
+
+        corsac::BasicView view(position, speed, tag);
+        assert->equal("size_hint()", view.size_hint(), 3);
+
+        int count = 0;
+        for (auto [ent, x, y, s] : view)
+        {
+            x += s;
+            y = s;
+            ++count;
+        }
+        assert->equal("entities joined", count, 2);
+        assert->equal("write through x", position.get<0>(3), 5);
+        assert->equal("write through y", position.get<1>(7), 5);
+        assert->equal("untouched", position.get<0>(9), 9);
+
+        int sum = 0;
+        view.each([&sum](corsac::EntityType, int& x, int&, int&) {
+            sum += x;
+        });
+        assert->equal("each()", sum, 5 + 12);
+    });
+    assert->add_block("empty driver", [](corsac::Block *assert) {
+        corsac::Component<int> speed;
+        corsac::Component<> tag;
+        speed.add(1, 1);
+
+        corsac::BasicView view(speed, tag);
+        assert->is_true("begin() == end()", view.begin() == view.end());
+    });
+    assert->add_block("changed_since", [](corsac::Block *assert) {
+        corsac::Component<int, int> position;
+        corsac::Component<int> speed;
+        corsac::Component<> tag;
+        position.track_changes();
+        speed.track_changes();
+
+        for (corsac::EntityType i = 0; i < 10; ++i)
+        {
+            position.add(i, 0, 0);
+            speed.add(i, 1);
+            tag.add(i);
+        }
+        const corsac::Tick added = corsac::current_tick();
+        const corsac::Tick frame = corsac::advance_tick();
+        assert->equal("added_at()", position.added_at(3), added);
+        assert->is_false("not changed", position.changed_since(3, frame));
+
+        position.fit(2, 5, 5);
+        position.set(4, 1, 1);
+        speed.get(6) = 3;
+        position.get<0>(8) += 1;
+        position.touch(9);
+        position.remove(0);
+
+        assert->is_true("fit()", position.changed_since(2, frame));
+        assert->is_false("added_since()", position.added_since(2, frame));
+        assert->equal("swapped tick", position.changed_at(9), frame);
+
+        int count = 0;
+        corsac::BasicView(position, speed, tag).changed_since(frame).each([&count](corsac::EntityType ent, int&, int&, int&) {
+            count += static_cast<int>(ent);
+        });
+        assert->equal("filtered", count, 2 + 4 + 6 + 8 + 9);
+
+        speed.track_changes(false);
+        assert->is_true("untracked", speed.changed_since(1, frame));
+        assert->equal("tracked only", corsac::BasicView(position, speed).changed_since(frame).size_hint(), 9);
+        const auto changed = corsac::BasicView(position, speed).changed_since(frame);
+        count = 0;
+        for (auto it = changed.begin(); it != changed.end(); ++it)
+            ++count;
+        assert->equal("iterator", count, 4);
+    });
+    return true;
+}
+
+#endif //ECS_VIEW_TEST_H
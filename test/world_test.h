@@ -0,0 +1,111 @@
+//
+// Created by Falldot on 17.10.2026.
+//
+
+#ifndef ECS_WORLD_TEST_H
+#define ECS_WORLD_TEST_H
+
+#include "Corsac/world.h"
+
+#include <thread>
+
+namespace world_test_data
+{
+    struct Position : corsac::Component<int, float> {};
+    struct Health   : corsac::Component<int> {};
+    struct Alive    : corsac::Component<> {};
+
+    using Match = corsac::World<Position, Health, Alive>;
+
+    // Один шаг матча: двигает всех живых и возвращает сумму координат.
+    inline int step(Match& match)
+    {
+        int sum = 0;
+        match.advance_tick();
+        match.view<Position, Alive>().each([&sum](corsac::EntityType, int& x, float&) {
+            ++x;
+            sum += x;
+        });
+        return sum;
+    }
+}
+
+bool world_test(corsac::Block* assert) {
+
+    using namespace world_test_data;
+
+    assert->add_block("independent", [](corsac::Block *assert) {
+        Match first;
+        Match second;
+        auto a = first.create().add<Position>(1, 1.0f).add<Health>(10).add<Alive>();
+        auto b = second.create().add<Position>(5, 5.0f).add<Health>(50);
+        assert->equal("same id", a.id(), b.id());
+        assert->equal("first", a.get<Position, 0>(), 1);
+        assert->equal("second", b.get<Position, 0>(), 5);
+        assert->equal("AoS", b.get<Health>(), 50);
+        assert->equal("own bits", first.storage<Position>().signature_bit(), second.storage<Position>().signature_bit());
+        assert->is_true("has()", first.has<Position, Health, Alive>(a.id()));
+        assert->is_false("other world", second.has<Position, Alive>(b.id()));
+        assert->equal("alive()", first.alive() + second.alive(), 2);
+    });
+    assert->add_block("destroy", [](corsac::Block *assert) {
+        Match match;
+        auto a = match.create().add<Position>(1, 1.0f).add<Alive>();
+        auto b = match.create().add<Position>(2, 2.0f).add<Health>(20).add<Alive>();
+        a.destroy();
+        assert->is_false("valid()", a.valid());
+        assert->is_false("removed", match.storage<Position>().has(a.id()) || match.storage<Alive>().has(a.id()));
+        assert->equal("view", step(match), 3);
+        b.remove<Alive>();
+        assert->equal("remove()", step(match), 0);
+        assert->is_false("has()", b.has<Position, Alive>());
+    });
+    assert->add_block("ticks", [](corsac::Block *assert) {
+        Match first;
+        Match second;
+        first.storage<Health>().track_changes();
+        second.storage<Health>().track_changes();
+        first.advance_tick();
+        first.advance_tick();
+        const corsac::EntityType a = first.create().add<Health>(1).id();
+        const corsac::EntityType b = second.create().add<Health>(2).id();
+        assert->equal("own clock", first.current_tick(), 3);
+        assert->equal("other clock", second.current_tick(), 1);
+        assert->is_true("first", first.storage<Health>().changed_since(a, 2));
+        assert->is_false("second", second.storage<Health>().changed_since(b, 2));
+    });
+    assert->add_block("threads", [](corsac::Block *assert) {
+        Match worlds[4];
+        int results[4] = {};
+        std::thread threads[4];
+        for (int w = 0; w < 4; ++w)
+        {
+            threads[w] = std::thread([&worlds, &results, w] {
+                Match& match = worlds[w];
+                for (int i = 0; i < 1000; ++i)
+                    match.create().add<Position>(w, 0.0f).add<Alive>();
+                for (int i = 0; i < 10; ++i)
+                    results[w] = step(match);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        for (int w = 0; w < 4; ++w)
+            assert->equal("result", results[w], (w + 10) * 1000);
+    });
+    assert->add_block("snapshot", [](corsac::Block *assert) {
+        Match match;
+        match.create().add<Position>(1, 1.5f).add<Health>(10);
+        corsac::Snapshot snapshot;
+        match.snapshot(snapshot);
+        match.clear();
+        snapshot.rewind();
+        assert->equal("clear()", match.alive(), 0);
+        assert->is_true("restore()", match.restore(snapshot));
+        assert->equal("values", match.get(0).get<Position, 1>(), 1.5f);
+        assert->equal("alive()", match.alive(), 1);
+    });
+    return true;
+}
+
+#endif //ECS_WORLD_TEST_H